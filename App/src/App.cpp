@@ -14,8 +14,9 @@ void LowLevelDemo(std::shared_ptr<Wave::Context> ctx, const std::filesystem::pat
 	if (engine.GetID() == Wave::ID::Invalid) // Make sure it is valid
 		std::cout << ctx->GetLastErrorMsg() << '\n';
 
-	// Use the context to create a sound from an engine and a filepath
-	Wave::Sound sound = ctx->CreateSoundFromFile(engine, path);
+	// Use the context to create a sound from an engine and a filepath, music is
+	// streamed so only a small window of it is ever decoded in memory
+	Wave::Sound sound = ctx->CreateSoundFromFile(engine, path, Wave::SoundLoadMode::Stream);
 	if (sound.GetID() == Wave::ID::Invalid) // Make sure it is valid
 		std::cout << ctx->GetLastErrorMsg() << '\n';
 
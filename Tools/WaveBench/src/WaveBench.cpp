@@ -0,0 +1,414 @@
+#include <Wave/Wave.h>
+
+#include <miniaudio/miniaudio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Headless benchmarks for Wave, everything runs on offline engines so no audio device is needed.
+//
+//   WaveBench [--out results.json] [--voices N] [--seconds S] [--mp3 file] [--flac file] [--wav file]
+//
+// Results are written as JSON (to stdout unless --out is given) so they can be diffed between releases:
+//   mixing  - voices mixed per second of wall time while rendering looping, spatialized sounds
+//   setters - average cost of one call to the common Sound setters and of one UpdateSounds entry
+//   churn   - CreateSoundFromFile + DestroySound pairs per second for an already cached file
+//   load    - time to open and fully decode a file, per format, with the decoded cache disabled
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions
+{
+	std::filesystem::path OutputPath = "";
+	uint32_t Voices = 256;
+	float Seconds = 10.0f;
+	uint32_t SetterCalls = 1000000;
+	uint32_t ChurnIterations = 2000;
+	uint32_t LoadIterations = 20;
+	std::vector<std::pair<std::string, std::filesystem::path>> LoadFiles;
+};
+
+struct LoadResult
+{
+	std::string Format = "";
+	double MinMilliseconds = 0.0;
+	double AvgMilliseconds = 0.0;
+	double MaxMilliseconds = 0.0;
+	bool Success = false;
+};
+
+static double SecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Writes a one second 440 Hz sine to use as the test signal, so the bench needs no assets
+static bool WriteTestSignal(const std::filesystem::path& path, uint32_t sampleRate)
+{
+	ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 1, sampleRate);
+	ma_encoder encoder;
+
+	if (ma_encoder_init_file(path.string().c_str(), &config, &encoder) != MA_SUCCESS)
+		return false;
+
+	std::vector<float> samples(sampleRate);
+	for (uint32_t i = 0; i < sampleRate; i++)
+		samples[i] = 0.25f * std::sin(2.0f * 3.14159265f * 440.0f * (float)i / (float)sampleRate);
+
+	ma_result res = ma_encoder_write_pcm_frames(&encoder, samples.data(), samples.size(), nullptr);
+	ma_encoder_uninit(&encoder);
+
+	return res == MA_SUCCESS;
+}
+
+static Wave::Engine CreateOfflineEngine(std::shared_ptr<Wave::Context> ctx)
+{
+	Wave::EngineSettings settings;
+	settings.Offline = true;
+	settings.Channels = 2;
+	settings.SampleRate = 48000;
+
+	return ctx->CreateEngine(settings);
+}
+
+static void BenchMixing(std::shared_ptr<Wave::Context> ctx, const std::filesystem::path& signal, const BenchOptions& options, std::ostream& json)
+{
+	Wave::Engine engine = CreateOfflineEngine(ctx);
+	std::vector<Wave::Sound> sounds;
+
+	for (uint32_t i = 0; i < options.Voices; i++)
+	{
+		Wave::Sound sound = ctx->CreateSoundFromFile(engine, signal, Wave::SoundLoadMode::Decode);
+		if (sound.GetID() == Wave::ID::Invalid)
+			break;
+
+		// Spread the voices around the listener so the spatializer does real work
+		float angle = (float)i / (float)options.Voices * 6.2831853f;
+		sound.SetPosition(Wave::Vec3(std::cos(angle) * 10.0f, 0.0f, std::sin(angle) * 10.0f));
+		sound.SetLooping(true);
+		sound.Play();
+		sounds.push_back(sound);
+	}
+
+	constexpr uint64_t BlockSize = 512;
+	uint32_t channels = engine.GetChannelCount();
+	uint64_t totalFrames = (uint64_t)(options.Seconds * (float)engine.GetSampleRate());
+	std::vector<float> block(BlockSize * channels);
+	uint64_t rendered = 0;
+
+	Clock::time_point start = Clock::now();
+
+	while (rendered < totalFrames)
+	{
+		uint64_t frames = std::min(BlockSize, totalFrames - rendered);
+		rendered += engine.Render(block.data(), frames);
+	}
+
+	double wallSeconds = SecondsSince(start);
+	double audioSeconds = (double)rendered / (double)engine.GetSampleRate();
+	double realtimeFactor = audioSeconds / wallSeconds;
+
+	json << "\t\"mixing\": {\n";
+	json << "\t\t\"voices\": " << sounds.size() << ",\n";
+	json << "\t\t\"frames\": " << rendered << ",\n";
+	json << "\t\t\"wall_seconds\": " << wallSeconds << ",\n";
+	json << "\t\t\"realtime_factor\": " << realtimeFactor << ",\n";
+	json << "\t\t\"voices_mixed_per_second\": " << realtimeFactor * (double)sounds.size() << ",\n";
+	json << "\t\t\"ns_per_frame\": " << wallSeconds * 1e9 / (double)rendered << "\n";
+	json << "\t},\n";
+
+	for (Wave::Sound sound : sounds)
+		ctx->DestroySound(sound);
+
+	ctx->DestroyEngine(engine);
+}
+
+template <typename Func>
+static double NanosecondsPerCall(uint32_t calls, Func&& func)
+{
+	Clock::time_point start = Clock::now();
+
+	for (uint32_t i = 0; i < calls; i++)
+		func(i);
+
+	return SecondsSince(start) * 1e9 / (double)calls;
+}
+
+static void BenchSetters(std::shared_ptr<Wave::Context> ctx, const std::filesystem::path& signal, const BenchOptions& options, std::ostream& json)
+{
+	Wave::Engine engine = CreateOfflineEngine(ctx);
+	std::vector<Wave::Sound> sounds;
+
+	for (uint32_t i = 0; i < options.Voices; i++)
+	{
+		Wave::Sound sound = ctx->CreateSoundFromFile(engine, signal, Wave::SoundLoadMode::Decode);
+		if (sound.GetID() == Wave::ID::Invalid)
+			break;
+
+		sounds.push_back(sound);
+	}
+
+	size_t count = sounds.size();
+	uint32_t calls = options.SetterCalls;
+
+	if (count == 0)
+	{
+		std::cerr << "Failed to create sounds for the setter bench: " << ctx->GetLastErrorMsg() << '\n';
+		ctx->DestroyEngine(engine);
+		return;
+	}
+
+	double setPosition = NanosecondsPerCall(calls, [&](uint32_t i) { sounds[i % count].SetPosition(Wave::Vec3((float)i, 0.0f, 1.0f)); });
+	double setVelocity = NanosecondsPerCall(calls, [&](uint32_t i) { sounds[i % count].SetVelocity(Wave::Vec3((float)i, 0.0f, 1.0f)); });
+	double setVolume = NanosecondsPerCall(calls, [&](uint32_t i) { sounds[i % count].SetVolume((float)(i & 1)); });
+	double setPitch = NanosecondsPerCall(calls, [&](uint32_t i) { sounds[i % count].SetPitch(1.0f + (float)(i & 1) * 0.5f); });
+	double getPosition = NanosecondsPerCall(calls, [&](uint32_t i) { volatile float x = sounds[i % count].GetPosition().X; (void)x; });
+
+	// Same positional work as SetPosition, but applied a frame's worth at a time
+	std::vector<Wave::SoundUpdate> updates(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		updates[i].SoundID = sounds[i];
+		updates[i].Flags = (uint32_t)Wave::SoundUpdateFlags::Position;
+	}
+
+	uint32_t batches = std::max(1u, calls / (uint32_t)count);
+	double updateSounds = NanosecondsPerCall(batches, [&](uint32_t i)
+	{
+		for (Wave::SoundUpdate& update : updates)
+			update.Position = Wave::Vec3((float)i, 0.0f, 1.0f);
+
+		ctx->UpdateSounds(updates);
+	}) / (double)count;
+
+	json << "\t\"setters\": {\n";
+	json << "\t\t\"calls\": " << calls << ",\n";
+	json << "\t\t\"set_position_ns\": " << setPosition << ",\n";
+	json << "\t\t\"set_velocity_ns\": " << setVelocity << ",\n";
+	json << "\t\t\"set_volume_ns\": " << setVolume << ",\n";
+	json << "\t\t\"set_pitch_ns\": " << setPitch << ",\n";
+	json << "\t\t\"get_position_ns\": " << getPosition << ",\n";
+	json << "\t\t\"update_sounds_per_entry_ns\": " << updateSounds << "\n";
+	json << "\t},\n";
+
+	for (Wave::Sound sound : sounds)
+		ctx->DestroySound(sound);
+
+	ctx->DestroyEngine(engine);
+}
+
+static void BenchChurn(std::shared_ptr<Wave::Context> ctx, const std::filesystem::path& signal, const BenchOptions& options, std::ostream& json)
+{
+	Wave::Engine engine = CreateOfflineEngine(ctx);
+
+	// Warm the decoded cache so only the create/destroy path itself is measured
+	ctx->PreloadSound(signal);
+
+	uint32_t failures = 0;
+	Clock::time_point start = Clock::now();
+
+	for (uint32_t i = 0; i < options.ChurnIterations; i++)
+	{
+		Wave::Sound sound = ctx->CreateSoundFromFile(engine, signal, Wave::SoundLoadMode::Decode);
+
+		if (sound.GetID() == Wave::ID::Invalid)
+		{
+			failures++;
+			continue;
+		}
+
+		ctx->DestroySound(sound);
+	}
+
+	double wallSeconds = SecondsSince(start);
+
+	json << "\t\"churn\": {\n";
+	json << "\t\t\"iterations\": " << options.ChurnIterations << ",\n";
+	json << "\t\t\"failures\": " << failures << ",\n";
+	json << "\t\t\"pairs_per_second\": " << (double)options.ChurnIterations / wallSeconds << ",\n";
+	json << "\t\t\"us_per_pair\": " << wallSeconds * 1e6 / (double)options.ChurnIterations << "\n";
+	json << "\t},\n";
+
+	ctx->UnloadSound(signal);
+	ctx->DestroyEngine(engine);
+}
+
+static LoadResult BenchLoad(std::shared_ptr<Wave::Context> ctx, Wave::Engine engine, const std::string& format, const std::filesystem::path& path, uint32_t iterations)
+{
+	LoadResult result;
+	result.Format = format;
+	result.MinMilliseconds = 1e30;
+
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		Clock::time_point start = Clock::now();
+		Wave::Sound sound = ctx->CreateSoundFromFile(engine, path, Wave::SoundLoadMode::Decode);
+		double milliseconds = SecondsSince(start) * 1e3;
+
+		if (sound.GetID() == Wave::ID::Invalid)
+		{
+			std::cerr << "Failed to load '" << path.string() << "': " << ctx->GetLastErrorMsg() << '\n';
+			return result;
+		}
+
+		ctx->DestroySound(sound);
+
+		result.MinMilliseconds = std::min(result.MinMilliseconds, milliseconds);
+		result.MaxMilliseconds = std::max(result.MaxMilliseconds, milliseconds);
+		result.AvgMilliseconds += milliseconds / (double)iterations;
+	}
+
+	result.Success = true;
+	return result;
+}
+
+static void BenchLoads(const BenchOptions& options, std::ostream& json)
+{
+	// A context of its own with the decoded cache disabled, so every load decodes the whole file
+	std::shared_ptr<Wave::Context> ctx = Wave::CreateContext();
+
+	Wave::ContextSettings settings;
+	settings.DecodedCacheBudget = 0;
+	settings.LoaderThreadCount = 0;
+	ctx->Init(settings);
+
+	Wave::Engine engine = CreateOfflineEngine(ctx);
+
+	json << "\t\"load\": [\n";
+
+	for (size_t i = 0; i < options.LoadFiles.size(); i++)
+	{
+		const auto& [format, path] = options.LoadFiles[i];
+		LoadResult result = BenchLoad(ctx, engine, format, path, options.LoadIterations);
+
+		json << "\t\t{ \"format\": \"" << result.Format << "\", \"success\": " << (result.Success ? "true" : "false");
+
+		if (result.Success)
+		{
+			json << ", \"bytes\": " << std::filesystem::file_size(path);
+			json << ", \"min_ms\": " << result.MinMilliseconds;
+			json << ", \"avg_ms\": " << result.AvgMilliseconds;
+			json << ", \"max_ms\": " << result.MaxMilliseconds;
+		}
+
+		json << " }" << (i + 1 < options.LoadFiles.size() ? "," : "") << '\n';
+	}
+
+	json << "\t]\n";
+
+	ctx->DestroyEngine(engine);
+	ctx->Shutdown();
+	Wave::DestroyContext(ctx);
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (value == nullptr)
+		{
+			std::cerr << "Missing value for: " << arg << '\n';
+			return false;
+		}
+
+		if (strcmp(arg, "--out") == 0)
+			options.OutputPath = value;
+		else if (strcmp(arg, "--voices") == 0)
+			options.Voices = std::max(1, atoi(value));
+		else if (strcmp(arg, "--seconds") == 0)
+			options.Seconds = std::max(0.1f, (float)atof(value));
+		else if (strcmp(arg, "--wav") == 0)
+			options.LoadFiles.emplace_back("wav", value);
+		else if (strcmp(arg, "--mp3") == 0)
+			options.LoadFiles.emplace_back("mp3", value);
+		else if (strcmp(arg, "--flac") == 0)
+			options.LoadFiles.emplace_back("flac", value);
+		else
+		{
+			std::cerr << "Unknown option: " << arg << '\n';
+			return false;
+		}
+
+		i++;
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << "Usage: WaveBench [--out results.json] [--voices N] [--seconds S] [--wav file] [--mp3 file] [--flac file]\n";
+		return 1;
+	}
+
+	std::filesystem::path signal = std::filesystem::temp_directory_path() / "wavebench_signal.wav";
+
+	if (!WriteTestSignal(signal, 48000))
+	{
+		std::cerr << "Failed to write test signal: " << signal << '\n';
+		return 1;
+	}
+
+	// The generated signal always gets a load entry, compressed formats only when given a file
+	bool hasWav = std::any_of(options.LoadFiles.begin(), options.LoadFiles.end(), [](const auto& file) { return file.first == "wav"; });
+	if (!hasWav)
+		options.LoadFiles.insert(options.LoadFiles.begin(), { "wav", signal });
+
+	std::shared_ptr<Wave::Context> ctx = Wave::CreateContext();
+	Wave::ContextResult result = ctx->Init(Wave::ContextSettings());
+
+	if (!result.Success)
+	{
+		std::cerr << ctx->GetLastErrorMsg() << '\n';
+		return 1;
+	}
+
+	std::ostringstream json;
+	json << "{\n";
+	json << "\t\"version\": 1,\n";
+	json << "\t\"voices\": " << options.Voices << ",\n";
+	json << "\t\"seconds\": " << options.Seconds << ",\n";
+
+	BenchMixing(ctx, signal, options, json);
+	BenchSetters(ctx, signal, options, json);
+	BenchChurn(ctx, signal, options, json);
+
+	ctx->Shutdown();
+	Wave::DestroyContext(ctx);
+
+	BenchLoads(options, json);
+	json << "}\n";
+
+	std::filesystem::remove(signal);
+
+	if (options.OutputPath.empty())
+	{
+		std::cout << json.str();
+		return 0;
+	}
+
+	std::ofstream stream(options.OutputPath, std::ios::trunc);
+	if (!stream)
+	{
+		std::cerr << "Failed to open output file: " << options.OutputPath << '\n';
+		return 1;
+	}
+
+	stream << json.str();
+	return 0;
+}
@@ -0,0 +1,203 @@
+#include <Wave/SoundBank.h>
+
+#include <miniaudio/miniaudio.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Packs every audio file under a directory into a single Wave sound bank.
+//
+//   WavePack <input directory> <output file> [--pcm s16|f32]
+//
+// Entries are named by their path relative to the input directory with forward slashes,
+// e.g. "sfx/footstep_01.wav". By default files are stored as-is and decoded on playback,
+// --pcm decodes them up front so the bank can be played without any decoding at runtime.
+
+struct PackedEntry
+{
+	Wave::SoundBankEntry Entry;
+	std::string Name;
+	std::vector<uint8_t> Payload;
+};
+
+static bool ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& out)
+{
+	std::ifstream stream(path, std::ios::binary | std::ios::ate);
+	if (!stream)
+		return false;
+
+	out.resize((size_t)stream.tellg());
+	stream.seekg(0);
+	stream.read((char*)out.data(), (std::streamsize)out.size());
+
+	return (bool)stream;
+}
+
+static bool PackFile(const std::filesystem::path& path, Wave::SoundBankCodec codec, PackedEntry& packed)
+{
+	std::vector<uint8_t> file;
+	if (!ReadFile(path, file))
+	{
+		std::cout << "Failed to read: " << path << '\n';
+		return false;
+	}
+
+	// Encoded payloads keep the file's native format, PCM payloads are converted while packing
+	ma_format format = ma_format_unknown;
+	if (codec == Wave::SoundBankCodec::PCMS16)
+		format = ma_format_s16;
+	else if (codec == Wave::SoundBankCodec::PCMF32)
+		format = ma_format_f32;
+
+	ma_decoder_config config = ma_decoder_config_init(format, 0, 0);
+	ma_decoder decoder;
+
+	if (ma_decoder_init_memory(file.data(), file.size(), &config, &decoder) != MA_SUCCESS)
+	{
+		// Not something miniaudio can decode, skip it rather than failing the whole bank
+		std::cout << "Skipping unsupported file: " << path << '\n';
+		return false;
+	}
+
+	ma_uint64 frameCount = 0;
+	ma_decoder_get_length_in_pcm_frames(&decoder, &frameCount);
+
+	packed.Entry.LengthInPCMFrames = frameCount;
+	packed.Entry.SampleRate = decoder.outputSampleRate;
+	packed.Entry.Channels = (uint16_t)decoder.outputChannels;
+	packed.Entry.Codec = codec;
+
+	if (codec == Wave::SoundBankCodec::Encoded)
+	{
+		packed.Payload = std::move(file);
+	}
+	else
+	{
+		size_t bytesPerFrame = (codec == Wave::SoundBankCodec::PCMS16 ? sizeof(int16_t) : sizeof(float)) * decoder.outputChannels;
+		packed.Payload.resize((size_t)frameCount * bytesPerFrame);
+
+		ma_uint64 framesRead = 0;
+		ma_decoder_read_pcm_frames(&decoder, packed.Payload.data(), frameCount, &framesRead);
+
+		packed.Payload.resize((size_t)framesRead * bytesPerFrame);
+		packed.Entry.LengthInPCMFrames = framesRead;
+	}
+
+	ma_decoder_uninit(&decoder);
+
+	packed.Entry.Length = packed.Payload.size();
+
+	return true;
+}
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::cout << "Usage: WavePack <input directory> <output file> [--pcm s16|f32]\n";
+		return 1;
+	}
+
+	std::filesystem::path inputDirectory = argv[1];
+	std::filesystem::path outputPath = argv[2];
+	Wave::SoundBankCodec codec = Wave::SoundBankCodec::Encoded;
+
+	if (argc >= 5 && strcmp(argv[3], "--pcm") == 0)
+	{
+		if (strcmp(argv[4], "s16") == 0)
+			codec = Wave::SoundBankCodec::PCMS16;
+		else if (strcmp(argv[4], "f32") == 0)
+			codec = Wave::SoundBankCodec::PCMF32;
+		else
+		{
+			std::cout << "Unknown PCM format: " << argv[4] << '\n';
+			return 1;
+		}
+	}
+
+	if (!std::filesystem::is_directory(inputDirectory))
+	{
+		std::cout << "Input is not a directory: " << inputDirectory << '\n';
+		return 1;
+	}
+
+	std::vector<PackedEntry> entries;
+
+	for (const auto& file : std::filesystem::recursive_directory_iterator(inputDirectory))
+	{
+		if (!file.is_regular_file())
+			continue;
+
+		PackedEntry packed = {};
+		packed.Name = std::filesystem::relative(file.path(), inputDirectory).generic_string();
+		packed.Entry.NameHash = Wave::SoundBank::HashName(packed.Name);
+
+		if (PackFile(file.path(), codec, packed))
+			entries.push_back(std::move(packed));
+	}
+
+	// The runtime binary searches the index, so it has to be sorted and free of collisions
+	std::sort(entries.begin(), entries.end(), [](const PackedEntry& a, const PackedEntry& b)
+	{
+		return a.Entry.NameHash < b.Entry.NameHash;
+	});
+
+	for (size_t i = 1; i < entries.size(); i++)
+	{
+		if (entries[i].Entry.NameHash == entries[i - 1].Entry.NameHash)
+		{
+			std::cout << "Name hash collision between '" << entries[i - 1].Name << "' and '" << entries[i].Name << "'\n";
+			return 1;
+		}
+	}
+
+	Wave::SoundBankHeader header = {};
+	header.Magic = Wave::SoundBankMagic;
+	header.Version = Wave::SoundBankVersion;
+	header.EntryCount = (uint32_t)entries.size();
+	header.IndexOffset = sizeof(Wave::SoundBankHeader);
+	header.DataOffset = AlignUp(header.IndexOffset + entries.size() * sizeof(Wave::SoundBankEntry), Wave::SoundBankPayloadAlignment);
+
+	uint64_t offset = header.DataOffset;
+	for (PackedEntry& packed : entries)
+	{
+		packed.Entry.Offset = offset;
+		offset = AlignUp(offset + packed.Entry.Length, Wave::SoundBankPayloadAlignment);
+	}
+
+	std::ofstream stream(outputPath, std::ios::binary | std::ios::trunc);
+	if (!stream)
+	{
+		std::cout << "Failed to open output file: " << outputPath << '\n';
+		return 1;
+	}
+
+	stream.write((const char*)&header, sizeof(header));
+	for (const PackedEntry& packed : entries)
+		stream.write((const char*)&packed.Entry, sizeof(packed.Entry));
+
+	const char padding[Wave::SoundBankPayloadAlignment] = {};
+	for (const PackedEntry& packed : entries)
+	{
+		stream.write(padding, (std::streamsize)(packed.Entry.Offset - (uint64_t)stream.tellp()));
+		stream.write((const char*)packed.Payload.data(), (std::streamsize)packed.Payload.size());
+	}
+
+	if (!stream)
+	{
+		std::cout << "Failed to write output file: " << outputPath << '\n';
+		return 1;
+	}
+
+	std::cout << "Packed " << entries.size() << " sounds into " << outputPath << " (" << (uint64_t)stream.tellp() << " bytes)\n";
+	return 0;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Wave/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Wave {
+
+	// Every heap allocation a context makes goes through one of these, so an application can account
+	// for (or arena) all of Wave's memory. Without callbacks it falls back to malloc and free.
+	// Alignments above what the callbacks guarantee are handled by over-allocating and keeping
+	// the original pointer just in front of the aligned block.
+	class Allocator
+	{
+	public:
+		Allocator() = default;
+
+		Allocator(const AllocationCallbacks& callbacks)
+		{
+			if (IsComplete(callbacks))
+			{
+				m_Callbacks = callbacks;
+			}
+		}
+
+		inline const AllocationCallbacks& GetCallbacks() const { return m_Callbacks; }
+
+		// miniaudio needs all three, a partial set is ignored
+		inline static bool IsComplete(const AllocationCallbacks& callbacks) { return callbacks.Malloc != nullptr && callbacks.Realloc != nullptr && callbacks.Free != nullptr; }
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			if (alignment <= alignof(std::max_align_t))
+			{
+				return RawAllocate(size);
+			}
+
+			uint8_t* raw = (uint8_t*)RawAllocate(size + alignment + sizeof(void*));
+
+			if (raw == nullptr)
+			{
+				return nullptr;
+			}
+
+			uintptr_t aligned = ((uintptr_t)raw + sizeof(void*) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			((void**)aligned)[-1] = raw;
+
+			return (void*)aligned;
+		}
+
+		void Free(void* ptr, size_t alignment = alignof(std::max_align_t))
+		{
+			if (ptr == nullptr)
+			{
+				return;
+			}
+
+			RawFree(alignment <= alignof(std::max_align_t) ? ptr : ((void**)ptr)[-1]);
+		}
+
+		template<typename T, typename... Args>
+		T* New(Args&&... args)
+		{
+			void* memory = Allocate(sizeof(T), alignof(T));
+			return memory != nullptr ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+		}
+
+		template<typename T>
+		void Delete(T* ptr)
+		{
+			if (ptr != nullptr)
+			{
+				ptr->~T();
+				Free(ptr, alignof(T));
+			}
+		}
+
+		// Value-initialized like new T[count]()
+		template<typename T>
+		T* NewArray(size_t count)
+		{
+			T* array = (T*)Allocate(sizeof(T) * count, alignof(T));
+
+			for (size_t i = 0; array != nullptr && i < count; i++)
+			{
+				new (&array[i]) T();
+			}
+
+			return array;
+		}
+
+		template<typename T>
+		void DeleteArray(T* array, size_t count)
+		{
+			if (array == nullptr)
+			{
+				return;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				array[i].~T();
+			}
+
+			Free(array, alignof(T));
+		}
+
+		// Shared by everything constructed before it's handed a context's allocator
+		inline static Allocator& GetDefault()
+		{
+			static Allocator s_Default;
+			return s_Default;
+		}
+
+	private:
+		inline void* RawAllocate(size_t size) { return m_Callbacks.Malloc != nullptr ? m_Callbacks.Malloc(size, m_Callbacks.pUserData) : std::malloc(size); }
+
+		inline void RawFree(void* ptr)
+		{
+			if (m_Callbacks.Free != nullptr)
+			{
+				m_Callbacks.Free(ptr, m_Callbacks.pUserData);
+			}
+			else
+			{
+				std::free(ptr);
+			}
+		}
+
+	private:
+		AllocationCallbacks m_Callbacks;
+	};
+
+	// Lets standard containers allocate through a context's Allocator. Propagates on copy, move
+	// and swap, so assigning a container built for a context also hands it the context's allocator.
+	template<typename T>
+	class StlAllocator
+	{
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		StlAllocator() = default;
+		StlAllocator(Allocator* allocator)
+			: m_Allocator(allocator) { }
+
+		template<typename U>
+		StlAllocator(const StlAllocator<U>& other)
+			: m_Allocator(other.GetAllocator()) { }
+
+		T* allocate(size_t count)
+		{
+			T* ptr = (T*)GetAllocator()->Allocate(sizeof(T) * count, alignof(T));
+
+			if (ptr == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+
+			return ptr;
+		}
+
+		void deallocate(T* ptr, size_t) { GetAllocator()->Free(ptr, alignof(T)); }
+
+		inline Allocator* GetAllocator() const { return m_Allocator != nullptr ? m_Allocator : &Allocator::GetDefault(); }
+
+		template<typename U>
+		bool operator==(const StlAllocator<U>& other) const { return GetAllocator() == other.GetAllocator(); }
+
+	private:
+		Allocator* m_Allocator = nullptr;
+	};
+
+	template<typename T>
+	using AllocatedVector = std::vector<T, StlAllocator<T>>;
+
+	// unique_ptr for objects made with Allocator::New
+	template<typename T>
+	struct AllocatorDeleter
+	{
+		Allocator* Owner = nullptr;
+
+		void operator()(T* ptr) const { Owner->Delete(ptr); }
+	};
+
+	template<typename T>
+	using AllocatedPtr = std::unique_ptr<T, AllocatorDeleter<T>>;
+
+	template<typename T, typename... Args>
+	AllocatedPtr<T> MakeAllocated(Allocator& allocator, Args&&... args)
+	{
+		return AllocatedPtr<T>(allocator.New<T>(std::forward<Args>(args)...), AllocatorDeleter<T>{ &allocator });
+	}
+
+}
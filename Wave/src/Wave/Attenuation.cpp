@@ -0,0 +1,338 @@
+#include "Attenuation.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define WAVE_ATTENUATION_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define WAVE_ATTENUATION_SSE2
+#endif
+
+namespace Wave {
+
+	namespace Attenuation {
+
+		static constexpr float Epsilon = 1e-6f;
+
+		float ComputeGain(const SoundSpatialStore::Page& page, uint32_t lane, const Vec3& listener)
+		{
+			// Relatively positioned sounds are already in listener space
+			float absolute = page.AbsoluteMask[lane];
+			float dx = page.PositionX[lane] - listener.X * absolute;
+			float dy = page.PositionY[lane] - listener.Y * absolute;
+			float dz = page.PositionZ[lane] - listener.Z * absolute;
+			float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+			float minDistance = page.MinDistance[lane];
+			float maxDistance = page.MaxDistance[lane];
+			float rolloff = page.Rolloff[lane];
+			AttenuationModel model = (AttenuationModel)page.Model[lane];
+
+			float gain = 1.0f;
+
+			if (model != AttenuationModel::None)
+			{
+				if (minDistance < maxDistance)
+				{
+					float d = std::min(std::max(distance, minDistance), maxDistance);
+
+					switch (model)
+					{
+						case AttenuationModel::Inverse:
+							gain = minDistance / std::max(minDistance + rolloff * (d - minDistance), Epsilon);
+							break;
+						case AttenuationModel::Linear:
+							gain = 1.0f - rolloff * (d - minDistance) / (maxDistance - minDistance);
+							break;
+						case AttenuationModel::Exponential:
+							gain = std::pow(std::max(d / std::max(minDistance, Epsilon), Epsilon), -rolloff);
+							break;
+						default:
+							break;
+					}
+				}
+
+				gain = std::min(std::max(gain, page.MinGain[lane]), page.MaxGain[lane]);
+			}
+
+			if (distance > Epsilon)
+			{
+				float dirX = page.DirectionX[lane];
+				float dirY = page.DirectionY[lane];
+				float dirZ = page.DirectionZ[lane];
+				float dirLength = std::sqrt(dirX * dirX + dirY * dirY + dirZ * dirZ);
+
+				// Angle between the sound's facing direction and the direction towards the listener
+				float cosAngle = -(dirX * dx + dirY * dy + dirZ * dz) / std::max(distance * dirLength, Epsilon);
+				float innerCos = page.ConeInnerCos[lane];
+				float outerCos = page.ConeOuterCos[lane];
+				float outerGain = page.ConeOuterGain[lane];
+
+				if (cosAngle <= innerCos)
+				{
+					if (cosAngle > outerCos)
+					{
+						float t = (cosAngle - outerCos) / std::max(innerCos - outerCos, Epsilon);
+						gain *= outerGain + (1.0f - outerGain) * t;
+					}
+					else
+					{
+						gain *= outerGain;
+					}
+				}
+			}
+
+			float spatial = page.SpatialMask[lane];
+			return spatial * gain + (1.0f - spatial);
+		}
+
+		uint32_t FindClosestListener(const ListenerSet& listeners, const Vec3& position)
+		{
+			uint32_t closest = 0;
+			float closestDistance = FLT_MAX;
+
+			for (uint32_t i = 0; i < listeners.Count; i++)
+			{
+				if (!listeners.Enabled[i])
+				{
+					continue;
+				}
+
+				float dx = position.X - listeners.X[i];
+				float dy = position.Y - listeners.Y[i];
+				float dz = position.Z - listeners.Z[i];
+				float distance = dx * dx + dy * dy + dz * dz;
+
+				if (distance < closestDistance)
+				{
+					closest = i;
+					closestDistance = distance;
+				}
+			}
+
+			return closest;
+		}
+
+		float ComputeGain(const SoundSpatialStore::Page& page, uint32_t lane, const ListenerSet& listeners)
+		{
+			float pinned = page.PinnedListener[lane];
+			uint32_t listener = 0;
+
+			if (pinned >= 0.0f && pinned < (float)listeners.Count)
+			{
+				listener = (uint32_t)pinned;
+			}
+			else
+			{
+				listener = FindClosestListener(listeners, Vec3(page.PositionX[lane], page.PositionY[lane], page.PositionZ[lane]));
+			}
+
+			return ComputeGain(page, lane, Vec3(listeners.X[listener], listeners.Y[listener], listeners.Z[listener]));
+		}
+
+#if defined(WAVE_ATTENUATION_AVX2)
+
+		struct Simd
+		{
+			using Type = __m256;
+			inline static constexpr uint32_t Width = 8;
+
+			inline static Type Load(const float* src) { return _mm256_load_ps(src); }
+			inline static void Store(float* dst, Type value) { _mm256_store_ps(dst, value); }
+			inline static Type Set(float value) { return _mm256_set1_ps(value); }
+
+			inline static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+			inline static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+			inline static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+			inline static Type Div(Type a, Type b) { return _mm256_div_ps(a, b); }
+			inline static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+			inline static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+			inline static Type Sqrt(Type a) { return _mm256_sqrt_ps(a); }
+
+			inline static Type Greater(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+			inline static Type Less(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			inline static Type Equal(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+			inline static Type Select(Type mask, Type a, Type b) { return _mm256_blendv_ps(b, a, mask); }
+			inline static Type And(Type a, Type b) { return _mm256_and_ps(a, b); }
+			inline static Type Or(Type a, Type b) { return _mm256_or_ps(a, b); }
+		};
+
+#elif defined(WAVE_ATTENUATION_SSE2)
+
+		struct Simd
+		{
+			using Type = __m128;
+			inline static constexpr uint32_t Width = 4;
+
+			inline static Type Load(const float* src) { return _mm_load_ps(src); }
+			inline static void Store(float* dst, Type value) { _mm_store_ps(dst, value); }
+			inline static Type Set(float value) { return _mm_set1_ps(value); }
+
+			inline static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+			inline static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+			inline static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+			inline static Type Div(Type a, Type b) { return _mm_div_ps(a, b); }
+			inline static Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+			inline static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+			inline static Type Sqrt(Type a) { return _mm_sqrt_ps(a); }
+
+			inline static Type Greater(Type a, Type b) { return _mm_cmpgt_ps(a, b); }
+			inline static Type Less(Type a, Type b) { return _mm_cmplt_ps(a, b); }
+			inline static Type Equal(Type a, Type b) { return _mm_cmpeq_ps(a, b); }
+			inline static Type Select(Type mask, Type a, Type b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+			inline static Type And(Type a, Type b) { return _mm_and_ps(a, b); }
+			inline static Type Or(Type a, Type b) { return _mm_or_ps(a, b); }
+		};
+
+#endif
+
+#if defined(WAVE_ATTENUATION_AVX2) || defined(WAVE_ATTENUATION_SSE2)
+
+		// Picks each lane's listener, its pinned one or else the closest enabled one, without branching per lane
+		static void SelectListeners(const SoundSpatialStore::Page& page, uint32_t lane, const ListenerSet& listeners, Simd::Type* x, Simd::Type* y, Simd::Type* z)
+		{
+			using V = Simd::Type;
+
+			*x = Simd::Set(listeners.X[0]);
+			*y = Simd::Set(listeners.Y[0]);
+			*z = Simd::Set(listeners.Z[0]);
+
+			if (listeners.Count <= 1)
+			{
+				return;
+			}
+
+			V positionX = Simd::Load(page.PositionX + lane);
+			V positionY = Simd::Load(page.PositionY + lane);
+			V positionZ = Simd::Load(page.PositionZ + lane);
+
+			// Pins past the listener count fall back to the closest listener, as they do in miniaudio
+			V pinned = Simd::Load(page.PinnedListener + lane);
+			V unpinned = Simd::Or(Simd::Less(pinned, Simd::Set(0.0f)), Simd::Greater(pinned, Simd::Set((float)listeners.Count - 0.5f)));
+			V closestDistance = Simd::Set(FLT_MAX);
+
+			for (uint32_t i = 0; i < listeners.Count; i++)
+			{
+				V listenerX = Simd::Set(listeners.X[i]);
+				V listenerY = Simd::Set(listeners.Y[i]);
+				V listenerZ = Simd::Set(listeners.Z[i]);
+
+				V take = Simd::Equal(pinned, Simd::Set((float)i));
+
+				if (listeners.Enabled[i])
+				{
+					V dx = Simd::Sub(positionX, listenerX);
+					V dy = Simd::Sub(positionY, listenerY);
+					V dz = Simd::Sub(positionZ, listenerZ);
+					V distance = Simd::Add(Simd::Add(Simd::Mul(dx, dx), Simd::Mul(dy, dy)), Simd::Mul(dz, dz));
+
+					V closer = Simd::And(unpinned, Simd::Less(distance, closestDistance));
+					closestDistance = Simd::Select(closer, distance, closestDistance);
+					take = Simd::Or(take, closer);
+				}
+
+				*x = Simd::Select(take, listenerX, *x);
+				*y = Simd::Select(take, listenerY, *y);
+				*z = Simd::Select(take, listenerZ, *z);
+			}
+		}
+
+		static void ComputeGainsSimd(SoundSpatialStore::Page& page, uint32_t laneCount, const ListenerSet& listeners)
+		{
+			using V = Simd::Type;
+
+			const V zero = Simd::Set(0.0f);
+			const V one = Simd::Set(1.0f);
+			const V epsilon = Simd::Set(Epsilon);
+			const V inverseModel = Simd::Set((float)AttenuationModel::Inverse);
+			const V linearModel = Simd::Set((float)AttenuationModel::Linear);
+			const V noneModel = Simd::Set((float)AttenuationModel::None);
+
+			// Pages are a multiple of the vector width, so running past laneCount
+			// to the next boundary only touches unused (but valid) lanes
+			for (uint32_t lane = 0; lane < laneCount; lane += Simd::Width)
+			{
+				V listenerX, listenerY, listenerZ;
+				SelectListeners(page, lane, listeners, &listenerX, &listenerY, &listenerZ);
+
+				V absolute = Simd::Load(page.AbsoluteMask + lane);
+				V dx = Simd::Sub(Simd::Load(page.PositionX + lane), Simd::Mul(listenerX, absolute));
+				V dy = Simd::Sub(Simd::Load(page.PositionY + lane), Simd::Mul(listenerY, absolute));
+				V dz = Simd::Sub(Simd::Load(page.PositionZ + lane), Simd::Mul(listenerZ, absolute));
+				V distance = Simd::Sqrt(Simd::Add(Simd::Add(Simd::Mul(dx, dx), Simd::Mul(dy, dy)), Simd::Mul(dz, dz)));
+
+				// Distance attenuation
+				V minDistance = Simd::Load(page.MinDistance + lane);
+				V maxDistance = Simd::Load(page.MaxDistance + lane);
+				V rolloff = Simd::Load(page.Rolloff + lane);
+				V model = Simd::Load(page.Model + lane);
+
+				V d = Simd::Min(Simd::Max(distance, minDistance), maxDistance);
+				V offset = Simd::Sub(d, minDistance);
+
+				V inverse = Simd::Div(minDistance, Simd::Max(Simd::Add(minDistance, Simd::Mul(rolloff, offset)), epsilon));
+				V linear = Simd::Sub(one, Simd::Div(Simd::Mul(rolloff, offset), Simd::Max(Simd::Sub(maxDistance, minDistance), epsilon)));
+
+				// Exponential lanes are patched up afterwards since there is no vector pow
+				V gain = Simd::Select(Simd::Equal(model, inverseModel), inverse, Simd::Select(Simd::Equal(model, linearModel), linear, one));
+				gain = Simd::Select(Simd::Less(minDistance, maxDistance), gain, one);
+				gain = Simd::Min(Simd::Max(gain, Simd::Load(page.MinGain + lane)), Simd::Load(page.MaxGain + lane));
+				gain = Simd::Select(Simd::Equal(model, noneModel), one, gain);
+
+				// Cone attenuation
+				V dirX = Simd::Load(page.DirectionX + lane);
+				V dirY = Simd::Load(page.DirectionY + lane);
+				V dirZ = Simd::Load(page.DirectionZ + lane);
+				V dirLength = Simd::Sqrt(Simd::Add(Simd::Add(Simd::Mul(dirX, dirX), Simd::Mul(dirY, dirY)), Simd::Mul(dirZ, dirZ)));
+
+				V dot = Simd::Add(Simd::Add(Simd::Mul(dirX, dx), Simd::Mul(dirY, dy)), Simd::Mul(dirZ, dz));
+				V cosAngle = Simd::Div(Simd::Sub(zero, dot), Simd::Max(Simd::Mul(distance, dirLength), epsilon));
+
+				V innerCos = Simd::Load(page.ConeInnerCos + lane);
+				V outerCos = Simd::Load(page.ConeOuterCos + lane);
+				V outerGain = Simd::Load(page.ConeOuterGain + lane);
+
+				V t = Simd::Div(Simd::Sub(cosAngle, outerCos), Simd::Max(Simd::Sub(innerCos, outerCos), epsilon));
+				V blended = Simd::Add(outerGain, Simd::Mul(Simd::Sub(one, outerGain), t));
+				V cone = Simd::Select(Simd::Greater(cosAngle, innerCos), one, Simd::Select(Simd::Greater(cosAngle, outerCos), blended, outerGain));
+				cone = Simd::Select(Simd::Greater(distance, epsilon), cone, one);
+
+				gain = Simd::Mul(gain, cone);
+
+				// Non-spatialized sounds always play at full gain
+				V spatial = Simd::Load(page.SpatialMask + lane);
+				gain = Simd::Add(Simd::Mul(spatial, gain), Simd::Sub(one, spatial));
+
+				Simd::Store(page.Gain + lane, gain);
+			}
+
+			for (uint32_t lane = 0; lane < laneCount; lane++)
+			{
+				if (page.Model[lane] == (float)AttenuationModel::Exponential)
+				{
+					page.Gain[lane] = ComputeGain(page, lane, listeners);
+				}
+			}
+		}
+
+#endif
+
+		void ComputeGains(SoundSpatialStore::Page& page, uint32_t laneCount, const ListenerSet& listeners)
+		{
+#if defined(WAVE_ATTENUATION_AVX2) || defined(WAVE_ATTENUATION_SSE2)
+			ComputeGainsSimd(page, laneCount, listeners);
+#else
+			for (uint32_t lane = 0; lane < laneCount; lane++)
+			{
+				page.Gain[lane] = ComputeGain(page, lane, listeners);
+			}
+#endif
+		}
+
+	}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Wave/SoundSpatialStore.h"
+#include "Wave/Types.h"
+
+#include <cstdint>
+
+namespace Wave {
+
+	namespace Attenuation {
+
+		/* Listener positions of an engine. Like miniaudio's spatializer, each sound is heard by its
+		   pinned listener, or by the closest enabled one when it isn't pinned. */
+		struct ListenerSet
+		{
+			float X[MaxListeners] = {};
+			float Y[MaxListeners] = {};
+			float Z[MaxListeners] = {};
+			bool Enabled[MaxListeners] = {};
+			uint32_t Count = 0;
+		};
+
+		// Computes the distance and cone gain every lane in a page would receive from its listener,
+		// clamped to each lane's min/max gain, and writes it to page.Gain.
+		// Uses AVX2 or SSE2 when available and falls back to scalar code otherwise.
+		void ComputeGains(SoundSpatialStore::Page& page, uint32_t laneCount, const ListenerSet& listeners);
+
+		// Scalar reference for a single lane, matches the vectorized path
+		float ComputeGain(const SoundSpatialStore::Page& page, uint32_t lane, const ListenerSet& listeners);
+		float ComputeGain(const SoundSpatialStore::Page& page, uint32_t lane, const Vec3& listener);
+
+		// Same choice miniaudio makes, disabled listeners are skipped and the first listener wins ties
+		uint32_t FindClosestListener(const ListenerSet& listeners, const Vec3& position);
+
+	}
+
+}
@@ -0,0 +1,196 @@
+#include "CallbackProfiler.h"
+
+#include "Wave/Assert.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <vector>
+
+namespace Wave {
+
+	CallbackProfiler::CallbackProfiler(uint32_t sampleRate, bool realtime, uint32_t traceCapacity, Allocator* allocator)
+		: m_SampleRate(sampleRate), m_Realtime(realtime), m_Allocator(allocator), m_TraceCapacity(traceCapacity)
+	{
+		WAVE_ASSERT(sampleRate != 0, "Profiler sample rate must not be zero!%s", "");
+
+		m_Epoch = GetTime();
+		m_Histogram = m_Allocator->NewArray<std::atomic<uint32_t>>(BucketCount);
+
+		if (traceCapacity != 0)
+		{
+			m_Trace = m_Allocator->NewArray<TraceEvent>(traceCapacity);
+		}
+	}
+
+	CallbackProfiler::~CallbackProfiler()
+	{
+		m_Allocator->DeleteArray(m_Histogram, BucketCount);
+		m_Allocator->DeleteArray(m_Trace, m_TraceCapacity);
+	}
+
+	uint64_t CallbackProfiler::GetTime()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void CallbackProfiler::Record(uint64_t startNanoseconds, uint64_t endNanoseconds, uint32_t frameCount)
+	{
+		if (m_ResetRequested.exchange(false, std::memory_order_acquire))
+		{
+			Clear();
+		}
+
+		// Only the audio thread writes, so plain load/store pairs are enough and cheaper than RMWs
+		uint64_t duration = endNanoseconds - startNanoseconds;
+		uint64_t budget = (uint64_t)frameCount * 1000000000ull / m_SampleRate;
+		uint64_t lastStart = m_LastStart.load(std::memory_order_relaxed);
+
+		m_Callbacks.store(m_Callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		m_TotalNanoseconds.store(m_TotalNanoseconds.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+		m_TotalBudgetNanoseconds.store(m_TotalBudgetNanoseconds.load(std::memory_order_relaxed) + budget, std::memory_order_relaxed);
+		m_LastBudgetNanoseconds.store(budget, std::memory_order_relaxed);
+
+		if (duration < m_MinNanoseconds.load(std::memory_order_relaxed))
+			m_MinNanoseconds.store(duration, std::memory_order_relaxed);
+
+		if (duration > m_MaxNanoseconds.load(std::memory_order_relaxed))
+			m_MaxNanoseconds.store(duration, std::memory_order_relaxed);
+
+		if (duration > budget)
+			m_Overruns.store(m_Overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		// A callback arriving more than two periods after the previous one means the device went without data
+		if (m_Realtime && lastStart != 0 && startNanoseconds - lastStart > budget * 2)
+			m_Xruns.store(m_Xruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		m_LastStart.store(startNanoseconds, std::memory_order_relaxed);
+
+		uint64_t bucket = std::min<uint64_t>(duration / BucketWidthNanoseconds, BucketCount - 1);
+		m_Histogram[bucket].store(m_Histogram[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		if (m_TraceCapacity != 0)
+		{
+			uint64_t written = m_TraceWritten.load(std::memory_order_relaxed);
+			TraceEvent& event = m_Trace[written % m_TraceCapacity];
+			event.Start.store(startNanoseconds - m_Epoch, std::memory_order_relaxed);
+			event.Duration.store(duration, std::memory_order_relaxed);
+			event.Frames.store(frameCount, std::memory_order_relaxed);
+			m_TraceWritten.store(written + 1, std::memory_order_release);
+		}
+	}
+
+	CallbackStats CallbackProfiler::GetStats() const
+	{
+		CallbackStats stats;
+		stats.Callbacks = m_Callbacks.load(std::memory_order_relaxed);
+		stats.Overruns = m_Overruns.load(std::memory_order_relaxed);
+		stats.Xruns = m_Xruns.load(std::memory_order_relaxed);
+		stats.ActiveVoices = m_ActiveVoices.load(std::memory_order_relaxed);
+		stats.BudgetMilliseconds = (float)m_LastBudgetNanoseconds.load(std::memory_order_relaxed) / 1e6f;
+
+		if (stats.Callbacks == 0)
+		{
+			return stats;
+		}
+
+		uint64_t total = m_TotalNanoseconds.load(std::memory_order_relaxed);
+		uint64_t totalBudget = m_TotalBudgetNanoseconds.load(std::memory_order_relaxed);
+		uint64_t maxNanoseconds = m_MaxNanoseconds.load(std::memory_order_relaxed);
+
+		stats.MinMilliseconds = (float)m_MinNanoseconds.load(std::memory_order_relaxed) / 1e6f;
+		stats.MaxMilliseconds = (float)maxNanoseconds / 1e6f;
+		stats.AvgMilliseconds = (float)((double)total / (double)stats.Callbacks / 1e6);
+		stats.BudgetUtilization = totalBudget != 0 ? (float)((double)total / (double)totalBudget) : 0.0f;
+
+		// The histogram may be a callback or two ahead of the counters, so count it on its own
+		uint64_t samples = 0;
+		for (uint32_t i = 0; i < BucketCount; i++)
+		{
+			samples += m_Histogram[i].load(std::memory_order_relaxed);
+		}
+
+		uint64_t target = samples - samples / 100;
+		uint64_t seen = 0;
+
+		for (uint32_t i = 0; i < BucketCount; i++)
+		{
+			seen += m_Histogram[i].load(std::memory_order_relaxed);
+
+			if (seen >= target && seen != 0)
+			{
+				// Upper edge of the bucket, never past the worst callback actually seen
+				uint64_t edge = std::min<uint64_t>((uint64_t)(i + 1) * BucketWidthNanoseconds, maxNanoseconds);
+				stats.P99Milliseconds = (float)edge / 1e6f;
+				break;
+			}
+		}
+
+		return stats;
+	}
+
+	ErrorCode CallbackProfiler::WriteChromeTrace(const std::filesystem::path& path) const
+	{
+		if (m_TraceCapacity == 0)
+		{
+			return ErrorCode::TracingDisabled;
+		}
+
+		// Copy the ring out first, then drop whatever the audio thread overwrote while we were copying
+		uint64_t end = m_TraceWritten.load(std::memory_order_acquire);
+		uint64_t begin = end > m_TraceCapacity ? end - m_TraceCapacity : 0;
+
+		struct Event { uint64_t Start; uint64_t Duration; uint32_t Frames; };
+		std::vector<Event> events;
+		events.reserve((size_t)(end - begin));
+
+		for (uint64_t i = begin; i < end; i++)
+		{
+			const TraceEvent& event = m_Trace[i % m_TraceCapacity];
+			events.push_back({ event.Start.load(std::memory_order_relaxed), event.Duration.load(std::memory_order_relaxed), event.Frames.load(std::memory_order_relaxed) });
+		}
+
+		uint64_t written = m_TraceWritten.load(std::memory_order_acquire);
+		uint64_t overwritten = written > end ? std::min<uint64_t>(written - end, events.size()) : 0;
+
+		std::ofstream stream(path, std::ios::trunc);
+
+		if (!stream)
+		{
+			return ErrorCode::FileWriteFailed;
+		}
+
+		// Complete ("X") events with microsecond timestamps, loadable in chrome://tracing and Perfetto
+		stream << "{\"traceEvents\":[\n";
+
+		for (size_t i = (size_t)overwritten; i < events.size(); i++)
+		{
+			const Event& event = events[i];
+			stream << std::format("{{\"name\":\"AudioCallback\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"frames\":{}}}}}{}\n",
+				(double)event.Start / 1e3, (double)event.Duration / 1e3, event.Frames, i + 1 < events.size() ? "," : "");
+		}
+
+		stream << "]}\n";
+
+		return stream ? ErrorCode::None : ErrorCode::FileWriteFailed;
+	}
+
+	void CallbackProfiler::Clear()
+	{
+		m_LastStart.store(0, std::memory_order_relaxed);
+		m_Callbacks.store(0, std::memory_order_relaxed);
+		m_TotalNanoseconds.store(0, std::memory_order_relaxed);
+		m_TotalBudgetNanoseconds.store(0, std::memory_order_relaxed);
+		m_MinNanoseconds.store(UINT64_MAX, std::memory_order_relaxed);
+		m_MaxNanoseconds.store(0, std::memory_order_relaxed);
+		m_Overruns.store(0, std::memory_order_relaxed);
+		m_Xruns.store(0, std::memory_order_relaxed);
+
+		for (uint32_t i = 0; i < BucketCount; i++)
+		{
+			m_Histogram[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Wave/Engine.h"
+#include "Wave/Allocator.h"
+#include "Wave/Error.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace Wave {
+
+	// Times every audio callback of an engine. Record runs on the audio thread and only ever
+	// touches atomics, so it never locks or allocates. Everything else may run on any thread.
+	// Durations go into a fixed histogram to get percentiles without keeping every sample,
+	// and optionally into a ring of the most recent callbacks for a Chrome trace.
+	class CallbackProfiler
+	{
+	public:
+		inline static constexpr uint32_t BucketCount = 2048;
+		inline static constexpr uint64_t BucketWidthNanoseconds = 10000; // 10 us, so 20 ms before the last bucket
+
+	public:
+		// Offline engines have no deadline to miss between callbacks, so they never count xruns
+		CallbackProfiler(uint32_t sampleRate, bool realtime, uint32_t traceCapacity, Allocator* allocator);
+		~CallbackProfiler();
+
+		CallbackProfiler(const CallbackProfiler&) = delete;
+		CallbackProfiler& operator=(const CallbackProfiler&) = delete;
+
+		// False when the histogram or trace ring couldn't be allocated, the profiler must not be used then
+		inline bool IsInitialized() const { return m_Histogram != nullptr && (m_TraceCapacity == 0 || m_Trace != nullptr); }
+
+		static uint64_t GetTime();
+
+		// Audio thread only
+		void Record(uint64_t startNanoseconds, uint64_t endNanoseconds, uint32_t frameCount);
+
+		// Called when the device is (re)started so the gap while it was stopped isn't seen as an xrun
+		inline void MarkStarted() { m_LastStart.store(0, std::memory_order_relaxed); }
+		inline void SetActiveVoices(uint32_t count) { m_ActiveVoices.store(count, std::memory_order_relaxed); }
+
+		CallbackStats GetStats() const;
+
+		// Applied by the audio thread on its next callback
+		inline void Reset() { m_ResetRequested.store(true, std::memory_order_release); }
+
+		// ErrorCode::None on success
+		ErrorCode WriteChromeTrace(const std::filesystem::path& path) const;
+
+	private:
+		void Clear();
+
+	private:
+		struct TraceEvent
+		{
+			std::atomic<uint64_t> Start = 0;
+			std::atomic<uint64_t> Duration = 0;
+			std::atomic<uint32_t> Frames = 0;
+		};
+
+	private:
+		uint32_t m_SampleRate = 0;
+		bool m_Realtime = false;
+		uint64_t m_Epoch = 0;
+
+		std::atomic<bool> m_ResetRequested = false;
+		std::atomic<uint64_t> m_LastStart = 0;
+		std::atomic<uint64_t> m_Callbacks = 0;
+		std::atomic<uint64_t> m_TotalNanoseconds = 0;
+		std::atomic<uint64_t> m_TotalBudgetNanoseconds = 0;
+		std::atomic<uint64_t> m_LastBudgetNanoseconds = 0;
+		std::atomic<uint64_t> m_MinNanoseconds = UINT64_MAX;
+		std::atomic<uint64_t> m_MaxNanoseconds = 0;
+		std::atomic<uint64_t> m_Overruns = 0;
+		std::atomic<uint64_t> m_Xruns = 0;
+		std::atomic<uint32_t> m_ActiveVoices = 0;
+		Allocator* m_Allocator = nullptr;
+		std::atomic<uint32_t>* m_Histogram = nullptr;
+
+		TraceEvent* m_Trace = nullptr;
+		uint32_t m_TraceCapacity = 0;
+		std::atomic<uint64_t> m_TraceWritten = 0;
+	};
+
+}
@@ -0,0 +1,117 @@
+#include "CommandQueue.h"
+
+#include "Wave/Assert.h"
+
+namespace Wave {
+
+	CommandQueue::~CommandQueue()
+	{
+		if (m_Cells != nullptr)
+		{
+			m_Allocator->DeleteArray(m_Cells, m_Mask + 1);
+		}
+	}
+
+	bool CommandQueue::Init(uint32_t capacity, Allocator* allocator)
+	{
+		WAVE_ASSERT(capacity > 0, "Command queue capacity must not be zero!%s", "");
+
+		uint64_t size = 1;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+
+		if (m_Cells != nullptr)
+		{
+			m_Allocator->DeleteArray(m_Cells, m_Mask + 1);
+		}
+
+		m_Allocator = allocator;
+		m_Cells = m_Allocator->NewArray<Cell>(size);
+		m_Mask = 0;
+
+		if (m_Cells == nullptr)
+		{
+			return false;
+		}
+
+		m_Mask = size - 1;
+
+		for (uint64_t i = 0; i < size; i++)
+		{
+			m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		m_EnqueuePosition.store(0, std::memory_order_relaxed);
+		m_DequeuePosition = 0;
+
+		return true;
+	}
+
+	bool CommandQueue::Push(const Command& command)
+	{
+		if (m_Cells == nullptr)
+		{
+			m_Dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		uint64_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+		Cell* cell = nullptr;
+
+		while (true)
+		{
+			cell = &m_Cells[position & m_Mask];
+			uint64_t sequence = cell->Sequence.load(std::memory_order_acquire);
+			int64_t difference = (int64_t)sequence - (int64_t)position;
+
+			if (difference == 0)
+			{
+				// The cell is free for this lap, claim it
+				if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				// The consumer hasn't freed this cell since the previous lap, so the queue is full
+				m_Dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				position = m_EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->Data = command;
+		cell->Sequence.store(position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool CommandQueue::Pop(Command& command)
+	{
+		if (m_Cells == nullptr)
+		{
+			return false;
+		}
+
+		Cell& cell = m_Cells[m_DequeuePosition & m_Mask];
+
+		// Empty, or the producer that claimed this cell hasn't finished writing it yet
+		if (cell.Sequence.load(std::memory_order_acquire) != m_DequeuePosition + 1)
+		{
+			return false;
+		}
+
+		command = cell.Data;
+		cell.Sequence.store(m_DequeuePosition + m_Mask + 1, std::memory_order_release);
+		m_DequeuePosition++;
+
+		return true;
+	}
+
+}
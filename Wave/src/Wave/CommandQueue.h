@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Wave/ID.h"
+#include "Wave/Allocator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+namespace Wave {
+
+	enum class CommandType : uint16_t
+	{
+		None = 0,
+
+		SoundPlay,
+		SoundRestart,
+		SoundPause,
+		SoundStop,
+		SoundSeek,
+		SoundUpdate,
+		SoundSetVolume,
+		SoundSetPitch,
+		SoundSetDopplerFactor,
+		SoundSetPosition,
+		SoundSetDirection,
+		SoundSetVelocity,
+		SoundSetAudioCone,
+		SoundSetMinGain,
+		SoundSetMaxGain,
+		SoundSetFalloff,
+		SoundSetMinDistance,
+		SoundSetMaxDistance,
+		SoundSetAttenuationModel,
+		SoundSetDirectionalAttenuationFactor,
+		SoundSetPan,
+		SoundSetPanMode,
+		SoundSetPositioning,
+		SoundSetPinnedListenerIndex,
+		SoundSetStartTimeInPCMFrames,
+		SoundSetStopTimeInPCMFrames,
+		SoundSetStopTimeWithFadeInPCMFrames,
+		SoundSetFadeInPCMFrames,
+		SoundSetFadeStartInPCMFrames,
+		SoundSetStartTimeInMilliseconds,
+		SoundSetStopTimeInMilliseconds,
+		SoundSetStopTimeWithFadeInMilliseconds,
+		SoundSetFadeInMilliseconds,
+		SoundSetFadeStartInMilliseconds,
+		SoundSetLooping,
+		SoundSetSpacialized,
+		SoundSetPriority,
+		SoundSetOcclusion,
+		SoundDestroy,
+
+		SoundGroupPlay,
+		SoundGroupRestart,
+		SoundGroupPause,
+		SoundGroupStop,
+		SoundGroupSetVolume,
+		SoundGroupSetPitch,
+		SoundGroupSetPan,
+		SoundGroupSetPosition,
+		SoundGroupSetDirection,
+		SoundGroupSetVelocity,
+		SoundGroupSetMinDistance,
+		SoundGroupSetMaxDistance,
+		SoundGroupSetAttenuationModel,
+		SoundGroupSetSpacialized,
+		SoundGroupDestroy,
+
+		EngineStart,
+		EngineStop,
+		EngineSetVirtualVoiceSettings,
+		EngineSetVoiceLimitSettings,
+		EngineUpdateListener,
+		EngineSetListenerWorldUp,
+		EngineSetListenerCone,
+		EngineSetListenerEnabled,
+		EngineSetOcclusionSettings,
+	};
+
+	/* A recorded call on a sound, sound group or engine. Arguments are packed into
+	   plain arrays so commands can be copied around without running constructors. */
+	struct Command
+	{
+		CommandType Type = CommandType::None;
+		uint32_t Flags = 0;
+		ID Target = ID::Invalid;
+		float Floats[10] = {};
+		uint64_t Integers[2] = {};
+	};
+
+	inline Command MakeCommand(CommandType type, ID target, std::initializer_list<float> floats = {}, std::initializer_list<uint64_t> integers = {})
+	{
+		Command command;
+		command.Type = type;
+		command.Target = target;
+
+		uint32_t i = 0;
+		for (float value : floats)
+			command.Floats[i++] = value;
+
+		i = 0;
+		for (uint64_t value : integers)
+			command.Integers[i++] = value;
+
+		return command;
+	}
+
+	// What Context::DeferCommand did with a call
+	enum class DeferResult : uint8_t
+	{
+		Immediate = 0, // Commands aren't deferred right now, the caller runs the call itself
+		Queued,
+		Rejected,      // The queue was full, the call is dropped and ErrorCode::CommandQueueFull recorded
+	};
+
+	// Bounded multi-producer, single-consumer queue. Any number of threads can push
+	// without taking a lock, only one thread may pop. Each cell carries a sequence
+	// number so producers claim a cell with one CAS and publish it with one store.
+	class CommandQueue
+	{
+	public:
+		CommandQueue() = default;
+		~CommandQueue();
+
+		CommandQueue(const CommandQueue&) = delete;
+		CommandQueue& operator=(const CommandQueue&) = delete;
+
+		// Capacity is rounded up to a power of two, the cells come from 'allocator'. Returns false
+		// when they can't be allocated, the queue then drops every push.
+		bool Init(uint32_t capacity, Allocator* allocator = &Allocator::GetDefault());
+
+		// Returns false without blocking when the queue is full
+		bool Push(const Command& command);
+		bool Pop(Command& command);
+
+		inline bool IsInitialized() const { return m_Cells != nullptr; }
+		inline uint32_t GetCapacity() const { return (uint32_t)(m_Mask + 1); }
+		inline uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+	private:
+		struct Cell
+		{
+			std::atomic<uint64_t> Sequence = 0;
+			Command Data;
+		};
+
+	private:
+		Cell* m_Cells = nullptr;
+		uint64_t m_Mask = 0;
+		Allocator* m_Allocator = nullptr;
+
+		// Kept on separate cache lines so producers and the consumer don't contend
+		alignas(64) std::atomic<uint64_t> m_EnqueuePosition = 0;
+		alignas(64) uint64_t m_DequeuePosition = 0;
+		alignas(64) std::atomic<uint64_t> m_Dropped = 0;
+	};
+
+}
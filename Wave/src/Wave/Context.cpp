@@ -3,11 +3,26 @@
 #include "Wave/Sound.h"
 #include "Wave/Engine.h"
 #include "Wave/Assert.h"
+#include "Wave/SlotMap.h"
+#include "Wave/SoundSpatialStore.h"
+#include "Wave/Attenuation.h"
+#include "Wave/SoundBank.h"
+#include "Wave/DecodedSoundCache.h"
+#include "Wave/WorkerPool.h"
+#include "Wave/CommandQueue.h"
+#include "Wave/CallbackProfiler.h"
+#include "Wave/Sequencer.h"
+#include "Wave/Allocator.h"
 
 #include <miniaudio/miniaudio.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
 #include <unordered_map>
-#include <format>
 
 namespace Wave {
 
@@ -24,372 +39,3667 @@ namespace Wave {
 	{
 		ma_sound Sound;
 		SoundData Data;
+
+		// Only set for sounds reading from caller-owned memory, see CreateSoundFromDataSource
+		// and CreateSoundFromBank. At most one of the two is in use.
+		ma_decoder* Decoder = nullptr;
+		ma_audio_buffer_ref* BufferRef = nullptr;
+
+		// Set when the sound plays a shared buffer from the decoded sound cache
+		DecodedSoundCache::Asset* CachedAsset = nullptr;
+
+		SoundLoadedCallback LoadedCallback = nullptr;
+		void* LoadedUserData = nullptr;
+
+		// Inserted between the sound and its output the first time it's occluded
+		ma_lpf_node* OcclusionFilter = nullptr;
+	};
+
+	// Hands a bus's mix to a BusEffectCallback
+	struct CallbackEffectNode
+	{
+		ma_node_base Base;
+		BusEffectCallback Callback;
+		void* UserData;
+		uint32_t Channels;
+	};
+
+	struct BusEffectNode
+	{
+		BusEffect Settings;
+
+		// Only the member matching Settings.Type is initialized
+		union
+		{
+			ma_lpf_node LowPass;
+			ma_hpf_node HighPass;
+			ma_bpf_node BandPass;
+			ma_delay_node Delay;
+			CallbackEffectNode Custom;
+		};
+
+		// Every member starts with its ma_node_base
+		inline ma_node* GetNode() { return (ma_node*)&LowPass; }
+	};
+
+	struct SoundGroupInternalData
+	{
+		ma_sound_group Group;
+		SoundGroupData Data;
+
+		// Chained between the group and its output in order, heap allocated so the nodes never move
+		AllocatedVector<AllocatedPtr<BusEffectNode>> Effects;
+	};
+
+	// A pooled one-shot voice, reading the pool's decoded asset through a cursor of its own
+	struct OneShotVoice
+	{
+		ma_sound Sound;
+		ma_audio_buffer_ref Buffer;
+		struct OneShotPool* Pool = nullptr;
+		uint32_t Index = 0;
+		bool Initialized = false;
+
+		// Index + 1 of the next voice while this one is on the free or finished list, 0 at the bottom
+		std::atomic<uint32_t> NextFree = 0;
+	};
+
+	// Voices for Engine::PlayOneShot. Free voices sit on a lock-free stack, so PlayOneShot on any
+	// thread takes them without locking. The end callback only parks played out voices on the finished
+	// list, Update moves them back to the free stack on the context thread once miniaudio is done with them.
+	struct OneShotPool
+	{
+		ID EngineID = ID::Invalid;
+		DecodedSoundCache::Asset* Asset = nullptr;
+		OneShotVoice* Voices = nullptr; // From the context's allocator, VoiceCount of them
+		uint32_t VoiceCount = 0;
+
+		// {tag:32, index + 1:32}, 0 when every voice is busy. The tag changes on every push and pop, so
+		// a voice taken and returned between a load and the CAS can't pass for the head that was loaded.
+		std::atomic<uint64_t> FreeHead = 0;
+		std::atomic<uint32_t> FreeCount = 0;
+
+		// Index + 1 of the last voice to play out, 0 when none are waiting. Only ever emptied as a whole,
+		// so the push in the end callback needs no tag.
+		std::atomic<uint32_t> FinishedHead = 0;
+
+		std::atomic<uint64_t> Plays = 0;
+		std::atomic<uint64_t> Rejections = 0;
+	};
+
+	// Idle, initialized sounds playing one file, see Context::CreateSoundPool. Parked sounds stay in
+	// the slot map under an ID only the pool knows, with their spatial lane released.
+	struct SoundPool
+	{
+		SoundPoolSettings Settings;
+		AllocatedVector<ID> Idle; // Reserved to MaxIdle so parking never allocates
+		std::chrono::steady_clock::time_point LastUsed;
+
+		uint64_t Hits = 0;
+		uint64_t Misses = 0;
+	};
+
+	// One round of line of sight checks, owned by the context thread except while InFlight
+	struct OcclusionBatch
+	{
+		OcclusionBatch(Allocator* allocator)
+			: Queries(allocator), Results(allocator) { }
+
+		AllocatedVector<OcclusionQuery> Queries;
+		AllocatedVector<float> Results;
+		std::atomic<bool> InFlight = false;
+
+		// Context thread only
+		bool Pending = false;
+		uint32_t Cursor = 0;
+		std::chrono::steady_clock::time_point LastDispatch;
+	};
+
+	// Loads an engine has queued on the context's loader threads, see CreateSoundFromFileAsync
+	struct EngineLoads
+	{
+		std::atomic<uint32_t> InFlight = 0;
+		std::atomic<bool> Cancelled = false; // Set by DestroyEngine, loads that haven't started are dropped
+	};
+
+	struct EngineInternalData
+	{
+		ma_engine Engine;
+		EngineData Data;
+
+		// Engines playing through a device own it, so the data callback can be timed
+		ma_device Device;
+		bool HasDevice = false;
+		AllocatedPtr<CallbackProfiler> Profiler;
+
+		AllocatedPtr<OcclusionBatch> Occlusion;
+		AllocatedPtr<EngineLoads> Loads;
+
+		// Null when the engine was created with a SequencerCapacity of 0
+		AllocatedPtr<Sequencer> Events;
+
+		// Owning context, so the audio callback can resolve the sounds events target
+		InternalData* ContextData = nullptr;
+
+		// Keyed by the path the decoded sound cache knows the file by
+		std::unordered_map<std::string, SoundPool, std::hash<std::string>, std::equal_to<std::string>, StlAllocator<std::pair<const std::string, SoundPool>>> SoundPools;
+	};
+
+	struct ContextPair
+	{
+		Context* pCtx;
+		ContextInternalData Data;
+	};
+
+	// Handed back from a loader thread, the slot is only touched by the loader until Update picks this up
+	struct SoundLoadResult
+	{
+		ID SoundID = ID::Invalid;
+		bool Success = false;
+		ErrorRecord Error; // Recorded on the loader thread, handed to the thread calling Update
+	};
+
+	// Scratch space for Context::UpdateSounds, reused by every call so the buffers
+	// only grow during the first few frames (or not at all with ReservedSounds set)
+	struct SoundUpdateBatch
+	{
+		SoundUpdateBatch(Allocator* allocator)
+			: Sounds(allocator), Indices(allocator), DirtyFlags(allocator) { }
+
+		AllocatedVector<ma_sound*> Sounds;
+		AllocatedVector<uint32_t> Indices;
+		AllocatedVector<uint32_t> DirtyFlags;
+
+		void Reserve(uint32_t count)
+		{
+			Sounds.reserve(count);
+			Indices.reserve(count);
+			DirtyFlags.reserve(count);
+		}
+
+		void Clear()
+		{
+			Sounds.clear();
+			Indices.clear();
+			DirtyFlags.clear();
+		}
+	};
+
+	struct InternalData
+	{
+		InternalData(const AllocationCallbacks& callbacks)
+			: Memory(callbacks), LoadedSounds(&Memory), PublishedSounds(&Memory), CommandUpdates(&Memory), UpdateBatch(&Memory)
+		{
+			const AllocationCallbacks& memory = Memory.GetCallbacks();
+			MiniaudioCallbacks = { memory.pUserData, memory.Malloc, memory.Realloc, memory.Free };
+
+			ActiveSounds.SetAllocator(&Memory);
+			SoundSpatial.SetAllocator(&Memory);
+			DecodedSounds.SetAllocator(&Memory);
+			ActiveSoundGroups.SetAllocator(&Memory);
+			ActiveEngines.SetAllocator(&Memory);
+			ActiveOneShotPools.SetAllocator(&Memory);
+		}
+
+		// Declared first so it outlives everything allocated through it
+		Allocator Memory;
+		ma_allocation_callbacks MiniaudioCallbacks; // Memory's callbacks, all null when using the system heap
+
+		SlotMap<SoundInternalData, SoundSpatialStore::PageSize, SoundSpatialStore::MaxPages> ActiveSounds;
+		SoundSpatialStore SoundSpatial;
+		DecodedSoundCache DecodedSounds;
+
+		WorkerPool SoundLoader;
+		std::mutex LoadedSoundsMutex;
+		AllocatedVector<SoundLoadResult> LoadedSounds;
+		AllocatedVector<SoundLoadResult> PublishedSounds;
+
+		// Runs the engines' occlusion query callbacks, started by the first engine that sets one
+		WorkerPool OcclusionQueries;
+
+		uint32_t ContextIndex = 0;
+		size_t StreamingThreshold = 0;
+
+		CommandQueue Commands;
+		AllocatedVector<SoundUpdate> CommandUpdates; // Consecutive SoundUpdate commands, applied as one batch
+		SoundUpdateBatch UpdateBatch;
+		bool DeferCommands = false;
+
+		SlotMap<SoundGroupInternalData> ActiveSoundGroups;
+		SlotMap<EngineInternalData> ActiveEngines;
+		SlotMap<AllocatedPtr<OneShotPool>> ActiveOneShotPools; // Boxed, voices point back at their pool
+
+		ContextPair CurrentContext;
 	};
 
-	struct SoundGroupInternalData
+	// Every initialized context, indexed by the context bits of the handles it hands out
+	static std::mutex s_ContextsMutex;
+	static std::atomic<InternalData*> s_Contexts[ID::MaxContexts] = {};
+
+	// Set while commands are being applied (and during Update), so the calls made on
+	// their behalf run right away instead of being recorded again
+	static thread_local bool s_ExecutingCommands = false;
+
+	// Occlusion only has to dull the highs, a single biquad per sound is plenty
+	static constexpr uint32_t OcclusionFilterOrder = 2;
+
+	namespace Utils {
+
+		// Returns nullptr for handles whose context was shut down (or never existed)
+		static InternalData* GetContextData(ID id)
+		{
+			return s_Contexts[id.GetContextIndex()].load(std::memory_order_acquire);
+		}
+
+		static SoundInternalData* GetSound(ID id)
+		{
+			InternalData* contextData = GetContextData(id);
+			return contextData != nullptr ? contextData->ActiveSounds.Get(id) : nullptr;
+		}
+
+		static SoundGroupInternalData* GetSoundGroup(ID id)
+		{
+			InternalData* contextData = GetContextData(id);
+			return contextData != nullptr ? contextData->ActiveSoundGroups.Get(id) : nullptr;
+		}
+
+		static EngineInternalData* GetEngine(ID id)
+		{
+			InternalData* contextData = GetContextData(id);
+			return contextData != nullptr ? contextData->ActiveEngines.Get(id) : nullptr;
+		}
+
+		static OneShotPool* GetOneShotPool(ID id)
+		{
+			InternalData* contextData = GetContextData(id);
+			AllocatedPtr<OneShotPool>* pool = contextData != nullptr ? contextData->ActiveOneShotPools.Get(id) : nullptr;
+			return pool != nullptr ? pool->get() : nullptr;
+		}
+
+		static void PushFreeVoice(OneShotPool* pool, uint32_t index)
+		{
+			uint64_t head = pool->FreeHead.load(std::memory_order_relaxed);
+			uint64_t next = 0;
+
+			do
+			{
+				pool->Voices[index].NextFree.store((uint32_t)head, std::memory_order_relaxed);
+				next = (((head >> 32) + 1) << 32) | (uint64_t)(index + 1);
+			}
+			while (!pool->FreeHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+
+			pool->FreeCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Returns UINT32_MAX when every voice is busy
+		static uint32_t PopFreeVoice(OneShotPool* pool)
+		{
+			uint64_t head = pool->FreeHead.load(std::memory_order_acquire);
+
+			while ((uint32_t)head != 0)
+			{
+				uint32_t index = (uint32_t)head - 1;
+				uint64_t next = (((head >> 32) + 1) << 32) | pool->Voices[index].NextFree.load(std::memory_order_relaxed);
+
+				if (pool->FreeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+				{
+					pool->FreeCount.fetch_sub(1, std::memory_order_relaxed);
+					return index;
+				}
+			}
+
+			return UINT32_MAX;
+		}
+
+		// Audio thread, the voice has played out. miniaudio is still inside its end handling for the sound
+		// here, so the voice is only handed out again once Update has recycled it.
+		static void OneShotEndCallback(void* userData, ma_sound* sound)
+		{
+			OneShotVoice* voice = (OneShotVoice*)userData;
+			OneShotPool* pool = voice->Pool;
+			uint32_t head = pool->FinishedHead.load(std::memory_order_relaxed);
+
+			do
+			{
+				voice->NextFree.store(head, std::memory_order_relaxed);
+			}
+			while (!pool->FinishedHead.compare_exchange_weak(head, voice->Index + 1, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		// Context thread, moves the voices that played out since the last Update back onto the free stack
+		static void RecycleOneShotVoices(InternalData* contextData)
+		{
+			for (uint32_t poolIndex = 0; poolIndex < contextData->ActiveOneShotPools.Capacity(); poolIndex++)
+			{
+				ID poolID = contextData->ActiveOneShotPools.GetIDByIndex(poolIndex);
+
+				if (poolID == ID::Invalid)
+				{
+					continue;
+				}
+
+				OneShotPool* pool = contextData->ActiveOneShotPools.Get(poolID)->get();
+				uint32_t head = pool->FinishedHead.exchange(0, std::memory_order_acquire);
+
+				while (head != 0)
+				{
+					uint32_t index = head - 1;
+					head = pool->Voices[index].NextFree.load(std::memory_order_relaxed);
+					PushFreeVoice(pool, index);
+				}
+			}
+		}
+
+		static void FreeOneShotPool(InternalData* contextData, ID poolID)
+		{
+			OneShotPool* pool = contextData->ActiveOneShotPools.Get(poolID)->get();
+
+			for (uint32_t i = 0; pool->Voices != nullptr && i < pool->VoiceCount; i++)
+			{
+				OneShotVoice& voice = pool->Voices[i];
+
+				if (voice.Initialized)
+				{
+					ma_sound_uninit(&voice.Sound);
+					ma_audio_buffer_ref_uninit(&voice.Buffer);
+				}
+			}
+
+			if (pool->Asset != nullptr)
+			{
+				contextData->DecodedSounds.Release(pool->Asset);
+			}
+
+			contextData->Memory.DeleteArray(pool->Voices, pool->VoiceCount);
+
+			contextData->ActiveOneShotPools.Get(poolID)->reset();
+			contextData->ActiveOneShotPools.Remove(poolID);
+		}
+
+		// Where a virtual sound's cursor would be had it kept playing, sets 'finished'
+		// when a non-looping sound would have run past its end in the meantime
+		static uint64_t ProjectVirtualCursor(ma_sound* sound, const SoundData& data, bool* finished)
+		{
+			ma_engine* engine = ma_sound_get_engine(sound);
+			uint64_t elapsed = ma_engine_get_time_in_pcm_frames(engine) - data.VirtualStartTimeInPCMFrames;
+
+			double rate = data.SampleRate != 0 ? (double)data.SampleRate / (double)ma_engine_get_sample_rate(engine) : 1.0;
+			uint64_t cursor = data.VirtualCursorInPCMFrames + (uint64_t)((double)elapsed * rate * data.Pitch);
+
+			*finished = false;
+
+			if (data.LengthInPCMFrames != 0 && cursor >= data.LengthInPCMFrames)
+			{
+				if (data.IsLooping)
+				{
+					cursor %= data.LengthInPCMFrames;
+				}
+				else
+				{
+					cursor = data.LengthInPCMFrames;
+					*finished = true;
+				}
+			}
+
+			return cursor;
+		}
+
+		// Drops voices that finished, were paused, stopped or destroyed since they were
+		// started and returns how many of the remaining ones are actually being mixed
+		static uint32_t PruneVoices(InternalData* contextData, EngineData& engine)
+		{
+			uint32_t active = 0;
+			size_t count = 0;
+
+			for (ID id : engine.Voices)
+			{
+				SoundInternalData* sound = contextData->ActiveSounds.Get(id);
+
+				if (sound == nullptr)
+				{
+					continue;
+				}
+
+				bool isVirtual = contextData->SoundSpatial.HasFlag(id.GetIndex(), SpatialFlag_Virtual);
+
+				if (!isVirtual && !ma_sound_is_playing(&sound->Sound))
+				{
+					sound->Data.IsVoiceTracked = false;
+					continue;
+				}
+
+				engine.Voices[count++] = id;
+				active += isVirtual ? 0 : 1;
+			}
+
+			engine.Voices.erase(engine.Voices.begin() + count, engine.Voices.end());
+			return active;
+		}
+
+		// Claims a sound slot along with its spatial lanes, returns ID::Invalid when out of slots
+		static ID AllocateSound(InternalData* contextData, ID engineID)
+		{
+			ID soundID = contextData->ActiveSounds.Insert();
+
+			if (soundID == ID::Invalid)
+			{
+				return ID::Invalid;
+			}
+
+			if (!contextData->SoundSpatial.Acquire(soundID.GetIndex(), engineID.GetIndex()))
+			{
+				contextData->ActiveSounds.Remove(soundID);
+				return ID::Invalid;
+			}
+
+			return soundID;
+		}
+
+		static void ReleaseOcclusionFilter(InternalData* contextData, SoundInternalData* data)
+		{
+			if (data->OcclusionFilter != nullptr)
+			{
+				ma_lpf_node_uninit(data->OcclusionFilter, &contextData->MiniaudioCallbacks);
+				contextData->Memory.Delete(data->OcclusionFilter);
+				data->OcclusionFilter = nullptr;
+			}
+		}
+
+		// Releases everything a sound owns apart from the ma_sound itself, which
+		// must already be uninitialized (or never have been initialized)
+		static void FreeSound(InternalData* contextData, ID soundID)
+		{
+			SoundInternalData* data = contextData->ActiveSounds.Get(soundID);
+
+			if (data->Decoder != nullptr)
+			{
+				ma_decoder_uninit(data->Decoder);
+				contextData->Memory.Delete(data->Decoder);
+				data->Decoder = nullptr;
+			}
+
+			if (data->BufferRef != nullptr)
+			{
+				ma_audio_buffer_ref_uninit(data->BufferRef);
+				contextData->Memory.Delete(data->BufferRef);
+				data->BufferRef = nullptr;
+			}
+
+			if (data->CachedAsset != nullptr)
+			{
+				contextData->DecodedSounds.Release(data->CachedAsset);
+				data->CachedAsset = nullptr;
+			}
+
+			ReleaseOcclusionFilter(contextData, data);
+
+			contextData->SoundSpatial.Release(soundID.GetIndex());
+			contextData->ActiveSounds.Remove(soundID);
+		}
+
+		// Plays already decoded frames owned by someone else, the sound only keeps a reference to them
+		static ma_result InitSoundFromFrames(InternalData* contextData, ma_engine* engine, SoundInternalData* data, ma_format format, uint32_t channels, uint32_t sampleRate, const void* frames, uint64_t frameCount)
+		{
+			data->BufferRef = contextData->Memory.New<ma_audio_buffer_ref>();
+
+			if (data->BufferRef == nullptr)
+			{
+				return MA_OUT_OF_MEMORY;
+			}
+
+			ma_result res = ma_audio_buffer_ref_init(format, channels, frames, frameCount, data->BufferRef);
+
+			if (res != MA_SUCCESS)
+			{
+				contextData->Memory.Delete(data->BufferRef);
+				data->BufferRef = nullptr;
+				return res;
+			}
+
+			data->BufferRef->sampleRate = sampleRate;
+
+			ma_sound_config config = ma_sound_config_init();
+			config.pDataSource = data->BufferRef;
+
+			return ma_sound_init_ex(engine, &config, &data->Sound);
+		}
+
+		// Caches the length and format of a freshly initialized sound, on failure the sound is uninitialized
+		static bool QuerySoundInfo(ID soundID, SoundInternalData* data)
+		{
+			ma_result res = ma_sound_get_length_in_seconds(&data->Sound, &data->Data.LengthInSeconds);
+
+			if (res != MA_SUCCESS)
+			{
+				ma_sound_uninit(&data->Sound);
+				SetLastError(ErrorCode::SoundInfoFailed, soundID);
+				return false;
+			}
+
+			res = ma_sound_get_length_in_pcm_frames(&data->Sound, &data->Data.LengthInPCMFrames);
+
+			if (res != MA_SUCCESS)
+			{
+				ma_sound_uninit(&data->Sound);
+				SetLastError(ErrorCode::SoundInfoFailed, soundID);
+				return false;
+			}
+
+			ma_sound_get_data_format(&data->Sound, nullptr, nullptr, &data->Data.SampleRate, nullptr, 0);
+
+			return true;
+		}
+
+		// Opens a file into an allocated sound slot. Safe to run on a loader thread as long as
+		// nothing else touches the slot, on failure the ma_sound is left uninitialized and
+		// whatever else was acquired is released by FreeSound.
+		static bool LoadSoundFromFile(InternalData* contextData, ID soundID, ma_engine* engine, SoundInternalData* data, const std::string& filepath, SoundLoadMode mode)
+		{
+			if (mode != SoundLoadMode::Stream)
+			{
+				// Every instance of a cached file shares one decoded buffer
+				size_t maxSize = mode == SoundLoadMode::Auto ? contextData->StreamingThreshold : SIZE_MAX;
+				bool tooLarge = false;
+				data->CachedAsset = contextData->DecodedSounds.Acquire(filepath, maxSize, &tooLarge);
+
+				if (data->CachedAsset == nullptr && !tooLarge)
+				{
+					return false;
+				}
+			}
+
+			ma_result res;
+
+			if (data->CachedAsset != nullptr)
+			{
+				const DecodedSoundCache::Asset* asset = data->CachedAsset;
+				res = InitSoundFromFrames(contextData, engine, data, ma_format_f32, asset->Channels, asset->SampleRate, asset->Frames, asset->FrameCount);
+				data->Data.LoadMode = SoundLoadMode::Decode;
+			}
+			else
+			{
+				// Streams are decoded by the resource manager's job thread into two pages that are
+				// refilled as playback crosses them, so memory stays flat regardless of length.
+				// A file forced to decode that doesn't fit the cache gets a private decoded buffer.
+				ma_sound_config config = ma_sound_config_init();
+				config.pFilePath = filepath.c_str();
+				config.flags = mode == SoundLoadMode::Decode ? MA_SOUND_FLAG_DECODE : MA_SOUND_FLAG_STREAM;
+
+				res = ma_sound_init_ex(engine, &config, &data->Sound);
+				data->Data.LoadMode = mode == SoundLoadMode::Decode ? SoundLoadMode::Decode : SoundLoadMode::Stream;
+			}
+
+			if (res != MA_SUCCESS)
+			{
+				SetLastError(ErrorCode::FileLoadFailed, soundID, 0, 0, filepath);
+				return false;
+			}
+
+			return QuerySoundInfo(soundID, data);
+		}
+
+		// Maps the sound's occlusion onto its low-pass and gain. The filter is only created once the sound is
+		// first occluded, and goes in front of whatever the sound was routed to before.
+		static bool ApplyOcclusion(InternalData* contextData, ID soundID, SoundInternalData* data)
+		{
+			float occlusion = data->Data.Occlusion;
+
+			if (data->OcclusionFilter == nullptr && occlusion == 0.0f)
+			{
+				return true;
+			}
+
+			SoundSpatialStore& store = contextData->SoundSpatial;
+			uint32_t index = soundID.GetIndex();
+			EngineInternalData* engineData = contextData->ActiveEngines.GetByIndex(store.GetEngineIndex(index));
+			WAVE_ASSERT(engineData != nullptr, "Sound with ID: '%zu' outlived its engine!", uint64_t(soundID));
+
+			if (engineData == nullptr)
+			{
+				SetLastError(ErrorCode::OcclusionFilterFailed, soundID);
+				return false;
+			}
+
+			const OcclusionSettings& settings = engineData->Data.Occlusion;
+
+			ma_engine* engine = ma_sound_get_engine(&data->Sound);
+			uint32_t sampleRate = ma_engine_get_sample_rate(engine);
+			uint32_t channels = ma_node_get_output_channels(&data->Sound, 0);
+
+			// Sweep the cutoff exponentially so equal steps in occlusion sound like equal steps in muffling
+			float maxCutoff = std::min(settings.MaxCutoffFrequency, (float)sampleRate * 0.45f);
+			float minCutoff = std::clamp(settings.MinCutoffFrequency, 1.0f, maxCutoff);
+			double cutoff = (double)maxCutoff * std::pow((double)minCutoff / (double)maxCutoff, (double)occlusion);
+			float gain = 1.0f + (settings.OccludedGain - 1.0f) * occlusion;
+
+			if (data->OcclusionFilter == nullptr)
+			{
+				ma_lpf_node_config config = ma_lpf_node_config_init(channels, sampleRate, cutoff, OcclusionFilterOrder);
+				data->OcclusionFilter = contextData->Memory.New<ma_lpf_node>();
+				ma_result res = data->OcclusionFilter != nullptr ? ma_lpf_node_init(ma_engine_get_node_graph(engine), &config, &contextData->MiniaudioCallbacks, data->OcclusionFilter) : MA_OUT_OF_MEMORY;
+
+				if (res != MA_SUCCESS)
+				{
+					contextData->Memory.Delete(data->OcclusionFilter);
+					data->OcclusionFilter = nullptr;
+					SetLastError(ErrorCode::OcclusionFilterFailed, soundID);
+					return false;
+				}
+
+				SoundGroupInternalData* group = data->Data.GroupID != ID::Invalid ? contextData->ActiveSoundGroups.Get(data->Data.GroupID) : nullptr;
+				ma_node* output = group != nullptr ? (ma_node*)&group->Group : ma_engine_get_endpoint(engine);
+
+				ma_node_attach_output_bus(data->OcclusionFilter, 0, output, 0);
+				ma_node_attach_output_bus(&data->Sound, 0, data->OcclusionFilter, 0);
+			}
+			else
+			{
+				ma_lpf_config config = ma_lpf_config_init(ma_format_f32, channels, sampleRate, cutoff, OcclusionFilterOrder);
+				ma_lpf_node_reinit(&config, data->OcclusionFilter);
+			}
+
+			ma_node_set_output_bus_volume(data->OcclusionFilter, 0, gain);
+			store.GetPageFor(index).OcclusionGain[SoundSpatialStore::GetLane(index)] = gain;
+
+			return true;
+		}
+
+		// Pushes everything set on a sound while it was loading to its freshly initialized ma_sound.
+		// Only values that differ from miniaudio's defaults are applied.
+		static void ApplyPendingSoundState(InternalData* contextData, ID soundID, SoundInternalData* data)
+		{
+			ma_sound* sound = &data->Sound;
+			const SoundData& state = data->Data;
+			const SoundData defaults;
+			SoundSpatialStore& store = contextData->SoundSpatial;
+			uint32_t index = soundID.GetIndex();
+
+			Vec3 position = store.GetPosition(index);
+			Vec3 velocity = store.GetVelocity(index);
+			Vec3 direction = store.GetDirection(index);
+			ma_sound_set_position(sound, position.X, position.Y, position.Z);
+			ma_sound_set_velocity(sound, velocity.X, velocity.Y, velocity.Z);
+			ma_sound_set_direction(sound, direction.X, direction.Y, direction.Z);
+
+			ma_sound_set_volume(sound, store.GetVolume(index));
+			ma_sound_set_min_distance(sound, store.GetMinDistance(index));
+			ma_sound_set_max_distance(sound, store.GetMaxDistance(index));
+			ma_sound_set_rolloff(sound, store.GetRolloff(index));
+			ma_sound_set_min_gain(sound, store.GetMinGain(index));
+			ma_sound_set_max_gain(sound, store.GetMaxGain(index));
+
+			float pinnedListener = store.GetPageFor(index).PinnedListener[SoundSpatialStore::GetLane(index)];
+			if (pinnedListener >= 0.0f)
+				ma_sound_set_pinned_listener_index(sound, (ma_uint32)pinnedListener);
+
+			if (state.Pitch != defaults.Pitch)
+				ma_sound_set_pitch(sound, state.Pitch);
+			if (state.DopplerFactor != defaults.DopplerFactor)
+				ma_sound_set_doppler_factor(sound, state.DopplerFactor);
+			if (state.DirectionalAttenuationFactor != defaults.DirectionalAttenuationFactor)
+				ma_sound_set_directional_attenuation_factor(sound, state.DirectionalAttenuationFactor);
+			if (state.Pan != defaults.Pan)
+				ma_sound_set_pan(sound, state.Pan);
+			if (state.PanMode != defaults.PanMode)
+				ma_sound_set_pan_mode(sound, (ma_pan_mode)state.PanMode);
+			if (state.Positioning_ != defaults.Positioning_)
+				ma_sound_set_positioning(sound, (ma_positioning)state.Positioning_);
+			if (state.Model != defaults.Model)
+				ma_sound_set_attenuation_model(sound, (ma_attenuation_model)state.Model);
+			if (state.Cone.InnerAngle != defaults.Cone.InnerAngle || state.Cone.OuterAngle != defaults.Cone.OuterAngle || state.Cone.OuterGain != defaults.Cone.OuterGain)
+				ma_sound_set_cone(sound, state.Cone.InnerAngle, state.Cone.OuterAngle, state.Cone.OuterGain);
+			if (state.IsLooping != defaults.IsLooping)
+				ma_sound_set_looping(sound, (ma_bool32)state.IsLooping);
+			if (state.Spacialized != defaults.Spacialized)
+				ma_sound_set_spatialization_enabled(sound, (ma_bool32)state.Spacialized);
+
+			// A sound that can't get its filter just plays unoccluded
+			ApplyOcclusion(contextData, soundID, data);
+		}
+
+		// Fails when 'groupID' is set but isn't a live group on 'engineID'
+		static bool CheckSoundGroup(InternalData* contextData, ID engineID, ID groupID)
+		{
+			if (groupID == ID::Invalid)
+			{
+				return true;
+			}
+
+			SoundGroupInternalData* group = contextData->ActiveSoundGroups.Get(groupID);
+
+			if (group == nullptr)
+			{
+				SetLastError(ErrorCode::InvalidSoundGroup, groupID);
+				return false;
+			}
+
+			if (group->Data.EngineID != engineID)
+			{
+				SetLastError(ErrorCode::GroupEngineMismatch, groupID);
+				return false;
+			}
+
+			return true;
+		}
+
+		// Drops destroyed sounds and child groups, along with sounds that were handed to another group
+		static void PruneGroupMembers(InternalData* contextData, ID groupID, SoundGroupData& group)
+		{
+			std::erase_if(group.Sounds, [contextData, groupID](ID soundID)
+			{
+				SoundInternalData* sound = contextData->ActiveSounds.Get(soundID);
+				return sound == nullptr || sound->Data.GroupID != groupID;
+			});
+
+			std::erase_if(group.Children, [contextData, groupID](ID childID)
+			{
+				SoundGroupInternalData* child = contextData->ActiveSoundGroups.Get(childID);
+				return child == nullptr || child->Data.ParentGroupID != groupID;
+			});
+		}
+
+		// Last node of a sound's chain, the one routed into its group or the engine
+		static ma_node* GetSoundTail(SoundInternalData* data)
+		{
+			return data->OcclusionFilter != nullptr ? (ma_node*)data->OcclusionFilter : (ma_node*)&data->Sound;
+		}
+
+		// Reroutes a freshly initialized sound from the engine into its group. Sounds start out stopped,
+		// so nothing is heard before the move. A group destroyed in the meantime leaves it on the engine.
+		static void AttachSoundToGroup(InternalData* contextData, ID soundID, SoundInternalData* data)
+		{
+			if (data->Data.GroupID == ID::Invalid)
+			{
+				return;
+			}
+
+			SoundGroupInternalData* group = contextData->ActiveSoundGroups.Get(data->Data.GroupID);
+
+			if (group == nullptr)
+			{
+				data->Data.GroupID = ID::Invalid;
+				return;
+			}
+
+			ma_node_attach_output_bus(GetSoundTail(data), 0, &group->Group, 0);
+
+			// Members are only pruned lazily, so catch up before the list would grow
+			std::vector<ID>& sounds = group->Data.Sounds;
+
+			if (sounds.size() == sounds.capacity())
+			{
+				PruneGroupMembers(contextData, data->Data.GroupID, group->Data);
+			}
+
+			sounds.push_back(soundID);
+		}
+
+		// Where a group's mix goes once it has been through its effects
+		static ma_node* GetGroupOutput(InternalData* contextData, SoundGroupInternalData* group)
+		{
+			if (group->Data.ParentGroupID != ID::Invalid)
+			{
+				SoundGroupInternalData* parent = contextData->ActiveSoundGroups.Get(group->Data.ParentGroupID);
+
+				if (parent != nullptr)
+				{
+					return &parent->Group;
+				}
+			}
+
+			return ma_engine_get_endpoint(ma_sound_get_engine(&group->Group));
+		}
+
+		// The last node of a group's chain, the group itself when it has no effects
+		static ma_node* GetGroupTail(SoundGroupInternalData* group)
+		{
+			return group->Effects.empty() ? (ma_node*)&group->Group : group->Effects.back()->GetNode();
+		}
+
+		static void ProcessCallbackEffect(ma_node* node, const float** framesIn, ma_uint32* frameCountIn, float** framesOut, ma_uint32* frameCountOut)
+		{
+			CallbackEffectNode* effect = (CallbackEffectNode*)node;
+			ma_uint32 frameCount = *frameCountOut;
+
+			ma_copy_pcm_frames(framesOut[0], framesIn[0], frameCount, ma_format_f32, effect->Channels);
+			effect->Callback(effect->UserData, framesOut[0], frameCount, effect->Channels);
+		}
+
+		// Processed even without input so tails (reverb, echoes) ring out after the bus goes quiet
+		static ma_node_vtable s_CallbackEffectVTable = { ProcessCallbackEffect, nullptr, 1, 1, MA_NODE_FLAG_CONTINUOUS_PROCESSING };
+
+		static ma_result InitBusEffect(ma_engine* engine, ma_uint32 channels, const ma_allocation_callbacks* allocationCallbacks, BusEffectNode* effect)
+		{
+			ma_node_graph* graph = ma_engine_get_node_graph(engine);
+			ma_uint32 sampleRate = ma_engine_get_sample_rate(engine);
+			const BusEffect& settings = effect->Settings;
+
+			switch (settings.Type)
+			{
+				case BusEffectType::LowPass:
+				{
+					ma_lpf_node_config config = ma_lpf_node_config_init(channels, sampleRate, settings.CutoffFrequency, settings.Order);
+					return ma_lpf_node_init(graph, &config, allocationCallbacks, &effect->LowPass);
+				}
+				case BusEffectType::HighPass:
+				{
+					ma_hpf_node_config config = ma_hpf_node_config_init(channels, sampleRate, settings.CutoffFrequency, settings.Order);
+					return ma_hpf_node_init(graph, &config, allocationCallbacks, &effect->HighPass);
+				}
+				case BusEffectType::BandPass:
+				{
+					ma_bpf_node_config config = ma_bpf_node_config_init(channels, sampleRate, settings.CutoffFrequency, settings.Order);
+					return ma_bpf_node_init(graph, &config, allocationCallbacks, &effect->BandPass);
+				}
+				case BusEffectType::Delay:
+				{
+					ma_uint32 delayInFrames = (ma_uint32)(settings.DelayInSeconds * (float)sampleRate);
+					ma_delay_node_config config = ma_delay_node_config_init(channels, sampleRate, delayInFrames, settings.Decay);
+					ma_result res = ma_delay_node_init(graph, &config, allocationCallbacks, &effect->Delay);
+
+					if (res == MA_SUCCESS)
+					{
+						ma_delay_node_set_wet(&effect->Delay, settings.Wet);
+						ma_delay_node_set_dry(&effect->Delay, settings.Dry);
+					}
+
+					return res;
+				}
+				case BusEffectType::Custom:
+				{
+					if (settings.Callback == nullptr)
+					{
+						return MA_INVALID_ARGS;
+					}
+
+					effect->Custom.Callback = settings.Callback;
+					effect->Custom.UserData = settings.pUserData;
+					effect->Custom.Channels = channels;
+
+					ma_node_config config = ma_node_config_init();
+					config.vtable = &s_CallbackEffectVTable;
+					config.pInputChannels = &channels;
+					config.pOutputChannels = &channels;
+
+					return ma_node_init(graph, &config, allocationCallbacks, &effect->Custom.Base);
+				}
+			}
+
+			return MA_INVALID_ARGS;
+		}
+
+		static void UninitBusEffect(BusEffectNode* effect, const ma_allocation_callbacks* allocationCallbacks)
+		{
+			switch (effect->Settings.Type)
+			{
+				case BusEffectType::LowPass:  ma_lpf_node_uninit(&effect->LowPass, allocationCallbacks); break;
+				case BusEffectType::HighPass: ma_hpf_node_uninit(&effect->HighPass, allocationCallbacks); break;
+				case BusEffectType::BandPass: ma_bpf_node_uninit(&effect->BandPass, allocationCallbacks); break;
+				case BusEffectType::Delay:    ma_delay_node_uninit(&effect->Delay, allocationCallbacks); break;
+				case BusEffectType::Custom:   ma_node_uninit(&effect->Custom.Base, allocationCallbacks); break;
+			}
+		}
+
+		// Audio thread. Only touches the ma_sound, the state kept on the context thread catches up
+		// when Context::Update goes through what was fired.
+		static void ApplySequencerEvent(InternalData* contextData, EngineInternalData* engineData, const SequencerEvent& event)
+		{
+			SoundInternalData* data = contextData->ActiveSounds.Get(event.SoundID);
+
+			if (data == nullptr || data->Data.LoadState != SoundLoadState::Loaded || ma_sound_get_engine(&data->Sound) != &engineData->Engine)
+			{
+				return;
+			}
+
+			ma_sound* sound = &data->Sound;
+			CommandType mirror = CommandType::None;
+
+			switch (event.Type)
+			{
+				case SequencerEventType::Play:
+					ma_sound_start(sound);
+					mirror = CommandType::SoundPlay;
+					break;
+				case SequencerEventType::Stop:
+					ma_sound_stop(sound);
+					ma_sound_seek_to_pcm_frame(sound, 0);
+					mirror = CommandType::SoundStop;
+					break;
+				case SequencerEventType::SetVolume:
+					ma_sound_set_volume(sound, event.Value);
+					mirror = CommandType::SoundSetVolume;
+					break;
+				case SequencerEventType::SetPitch:
+					ma_sound_set_pitch(sound, event.Value);
+					mirror = CommandType::SoundSetPitch;
+					break;
+				case SequencerEventType::SetPan:
+					ma_sound_set_pan(sound, event.Value);
+					mirror = CommandType::SoundSetPan;
+					break;
+				case SequencerEventType::Fade:
+					ma_sound_set_fade_in_pcm_frames(sound, event.FadeFrom, event.Value, event.FadeLengthInPCMFrames);
+					break;
+			}
+
+			if (mirror != CommandType::None)
+			{
+				engineData->Events->GetFired().Push(MakeCommand(mirror, event.SoundID, { event.Value }));
+			}
+		}
+
+		// Mixes 'frameCount' frames, cutting the read short at every scheduled event so it's applied at its exact frame
+		static ma_result ReadEngineFrames(InternalData* contextData, EngineInternalData* engineData, float* output, ma_uint64 frameCount, ma_uint64* framesRead)
+		{
+			ma_engine* engine = &engineData->Engine;
+			Sequencer* sequencer = engineData->Events.get();
+
+			if (sequencer == nullptr)
+			{
+				return ma_engine_read_pcm_frames(engine, output, frameCount, framesRead);
+			}
+
+			sequencer->Collect();
+
+			uint32_t channels = ma_engine_get_channels(engine);
+			ma_uint64 framesDone = 0;
+			ma_result res = MA_SUCCESS;
+			SequencerEvent event;
+
+			while (framesDone < frameCount)
+			{
+				uint64_t now = ma_engine_get_time_in_pcm_frames(engine);
+
+				if (sequencer->GetNextTime() <= now)
+				{
+					std::unique_lock<std::mutex> lock(sequencer->GetApplyMutex(), std::try_to_lock);
+
+					// Otherwise a sound is being destroyed right now, the events go out a period late
+					if (lock.owns_lock())
+					{
+						while (sequencer->PopDue(now, event))
+						{
+							ApplySequencerEvent(contextData, engineData, event);
+						}
+					}
+				}
+
+				uint64_t next = sequencer->GetNextTime();
+				ma_uint64 framesToRead = frameCount - framesDone;
+
+				if (next > now && next - now < framesToRead)
+				{
+					framesToRead = next - now;
+				}
+
+				ma_uint64 framesReadNow = 0;
+				res = ma_engine_read_pcm_frames(engine, output + framesDone * channels, framesToRead, &framesReadNow);
+				framesDone += framesReadNow;
+
+				if (res != MA_SUCCESS || framesReadNow < framesToRead)
+				{
+					break;
+				}
+			}
+
+			if (framesRead != nullptr)
+			{
+				*framesRead = framesDone;
+			}
+
+			return res;
+		}
+
+		// Does what miniaudio's own engine callback does, wrapped in the profiler's timing
+		static void EngineDataCallback(ma_device* device, void* output, const void* input, ma_uint32 frameCount)
+		{
+			EngineInternalData* data = (EngineInternalData*)device->pUserData;
+
+			uint64_t start = CallbackProfiler::GetTime();
+			ReadEngineFrames(data->ContextData, data, (float*)output, frameCount, nullptr);
+			data->Profiler->Record(start, CallbackProfiler::GetTime(), frameCount);
+		}
+
+		// Keeps the audio thread from applying events while a sound on the engine changes underneath it,
+		// the lock is empty for engines without a sequencer
+		static std::unique_lock<std::mutex> LockSequencer(InternalData* contextData, ID soundID)
+		{
+			EngineInternalData* engineData = contextData->ActiveEngines.GetByIndex(contextData->SoundSpatial.GetEngineIndex(soundID.GetIndex()));
+
+			if (engineData == nullptr || engineData->Events == nullptr)
+			{
+				return std::unique_lock<std::mutex>();
+			}
+
+			return std::unique_lock<std::mutex>(engineData->Events->GetApplyMutex());
+		}
+
+		// Puts a used sound back into the state ma_sound_init leaves it in, routed straight to the engine.
+		// Only what describes the file itself survives.
+		static void ResetPooledSound(InternalData* contextData, SoundInternalData* data)
+		{
+			ma_sound* sound = &data->Sound;
+			ma_engine* engine = ma_sound_get_engine(sound);
+
+			ma_sound_stop(sound);
+			ma_sound_seek_to_pcm_frame(sound, 0);
+			ma_sound_set_start_time_in_pcm_frames(sound, 0);
+			ma_sound_set_stop_time_in_pcm_frames(sound, ~(ma_uint64)0);
+			ma_sound_set_fade_in_pcm_frames(sound, 1.0f, 1.0f, 0);
+
+			ma_sound_set_volume(sound, 1.0f);
+			ma_sound_set_pitch(sound, 1.0f);
+			ma_sound_set_pan(sound, 0.0f);
+			ma_sound_set_pan_mode(sound, ma_pan_mode_balance);
+			ma_sound_set_looping(sound, MA_FALSE);
+
+			ma_sound_set_spatialization_enabled(sound, MA_TRUE);
+			ma_sound_set_pinned_listener_index(sound, MA_LISTENER_INDEX_CLOSEST);
+			ma_sound_set_positioning(sound, ma_positioning_absolute);
+			ma_sound_set_position(sound, 0.0f, 0.0f, 0.0f);
+			ma_sound_set_direction(sound, 0.0f, 0.0f, -1.0f);
+			ma_sound_set_velocity(sound, 0.0f, 0.0f, 0.0f);
+			ma_sound_set_attenuation_model(sound, ma_attenuation_model_inverse);
+			ma_sound_set_rolloff(sound, 1.0f);
+			ma_sound_set_min_gain(sound, 0.0f);
+			ma_sound_set_max_gain(sound, 1.0f);
+			ma_sound_set_min_distance(sound, 1.0f);
+			ma_sound_set_max_distance(sound, 3.4028235e+38f);
+			ma_sound_set_cone(sound, 6.283185f, 6.283185f, 0.0f);
+			ma_sound_set_doppler_factor(sound, 1.0f);
+			ma_sound_set_directional_attenuation_factor(sound, 1.0f);
+
+			ma_node_attach_output_bus(sound, 0, ma_engine_get_endpoint(engine), 0);
+			ReleaseOcclusionFilter(contextData, data);
+
+			SoundData fresh;
+			fresh.LengthInSeconds = data->Data.LengthInSeconds;
+			fresh.LengthInPCMFrames = data->Data.LengthInPCMFrames;
+			fresh.SampleRate = data->Data.SampleRate;
+			fresh.LoadMode = data->Data.LoadMode;
+			data->Data = fresh;
+
+			data->LoadedCallback = nullptr;
+			data->LoadedUserData = nullptr;
+		}
+
+		// Keeps a destroyed sound in its file's pool instead of uninitializing it. The caller's handle goes
+		// stale just like it would have. Returns false when there's no pool for the file or it's full.
+		static bool ParkPooledSound(InternalData* contextData, ID soundID, SoundInternalData* data)
+		{
+			if (data->CachedAsset == nullptr)
+			{
+				return false;
+			}
+
+			uint32_t index = soundID.GetIndex();
+			EngineInternalData* engineData = contextData->ActiveEngines.GetByIndex(contextData->SoundSpatial.GetEngineIndex(index));
+
+			if (engineData == nullptr)
+			{
+				return false;
+			}
+
+			auto it = engineData->SoundPools.find(data->CachedAsset->Path);
+
+			if (it == engineData->SoundPools.end() || it->second.Idle.size() >= it->second.Settings.MaxIdle)
+			{
+				return false;
+			}
+
+			// Out of reach of scheduled events before it's touched
+			std::unique_lock<std::mutex> lock = LockSequencer(contextData, soundID);
+			ID parkedID = contextData->ActiveSounds.Reissue(soundID);
+			lock.unlock();
+
+			ResetPooledSound(contextData, data);
+			contextData->SoundSpatial.Release(index);
+
+			SoundPool& pool = it->second;
+			pool.Idle.push_back(parkedID);
+			pool.LastUsed = std::chrono::steady_clock::now();
+
+			return true;
+		}
+
+		// Hands out an idle instance of a pooled file under a new handle, ID::Invalid when there's none
+		static ID TakePooledSound(InternalData* contextData, ID engineID, EngineInternalData* engineData, const std::string& path)
+		{
+			auto it = engineData->SoundPools.find(path);
+
+			if (it == engineData->SoundPools.end())
+			{
+				return ID::Invalid;
+			}
+
+			SoundPool& pool = it->second;
+			pool.LastUsed = std::chrono::steady_clock::now();
+
+			if (pool.Idle.empty())
+			{
+				pool.Misses++;
+				return ID::Invalid;
+			}
+
+			ID soundID = contextData->ActiveSounds.Reissue(pool.Idle.back());
+			pool.Idle.pop_back();
+			pool.Hits++;
+
+			// The lane's page is still around from when the sound was first created
+			contextData->SoundSpatial.Acquire(soundID.GetIndex(), engineID.GetIndex());
+
+			return soundID;
+		}
+
+		// Idle instances are unreachable from outside, nothing else can be using them
+		static void FreePooledSound(InternalData* contextData, ID parkedID)
+		{
+			ma_sound_uninit(&contextData->ActiveSounds.Get(parkedID)->Sound);
+			FreeSound(contextData, parkedID);
+		}
+
+		// Frees the engine's sounds whose loads finished but were never published, the engine's loads
+		// must all be done by now
+		static void DropLoadedSounds(InternalData* contextData, ID engineID)
+		{
+			std::scoped_lock<std::mutex> lock(contextData->LoadedSoundsMutex);
+
+			std::erase_if(contextData->LoadedSounds, [contextData, engineID](const SoundLoadResult& result)
+			{
+				if (contextData->SoundSpatial.GetEngineIndex(result.SoundID.GetIndex()) != engineID.GetIndex())
+				{
+					return false;
+				}
+
+				if (result.Success)
+				{
+					ma_sound_uninit(&contextData->ActiveSounds.Get(result.SoundID)->Sound);
+				}
+
+				FreeSound(contextData, result.SoundID);
+				return true;
+			});
+		}
+
+		// Uninitializes a group without handing its members over to its parent
+		static void FreeSoundGroup(InternalData* contextData, ID groupID)
+		{
+			SoundGroupInternalData* data = contextData->ActiveSoundGroups.Get(groupID);
+
+			ma_sound_group_uninit(&data->Group);
+
+			for (AllocatedPtr<BusEffectNode>& effect : data->Effects)
+			{
+				UninitBusEffect(effect.get(), &contextData->MiniaudioCallbacks);
+			}
+
+			data->Effects.clear();
+			contextData->ActiveSoundGroups.Remove(groupID);
+		}
+
+		// Frees everything created on an engine while the engine is still there to detach it from. Its device
+		// and loads must be stopped already, so nothing else can be touching any of it.
+		static void FreeEngineObjects(InternalData* contextData, ID engineID, EngineInternalData* engineData)
+		{
+			// Parked sounds have no spatial lane, they're only reachable through their pool
+			for (auto& [path, pool] : engineData->SoundPools)
+			{
+				for (ID parkedID : pool.Idle)
+				{
+					FreePooledSound(contextData, parkedID);
+				}
+			}
+
+			engineData->SoundPools.clear();
+
+			DropLoadedSounds(contextData, engineID);
+
+			for (uint32_t poolIndex = 0; poolIndex < contextData->ActiveOneShotPools.Capacity(); poolIndex++)
+			{
+				ID poolID = contextData->ActiveOneShotPools.GetIDByIndex(poolIndex);
+
+				if (poolID != ID::Invalid && contextData->ActiveOneShotPools.Get(poolID)->get()->EngineID == engineID)
+				{
+					FreeOneShotPool(contextData, poolID);
+				}
+			}
+
+			SoundSpatialStore& store = contextData->SoundSpatial;
+
+			for (uint32_t soundIndex = 0; soundIndex < contextData->ActiveSounds.Capacity(); soundIndex++)
+			{
+				ID soundID = contextData->ActiveSounds.GetIDByIndex(soundIndex);
+
+				if (soundID == ID::Invalid || !store.HasFlag(soundIndex, SpatialFlag_Active) || store.GetEngineIndex(soundIndex) != engineID.GetIndex())
+				{
+					continue;
+				}
+
+				SoundInternalData* data = contextData->ActiveSounds.Get(soundID);
+
+				if (data->Data.LoadState == SoundLoadState::Loaded)
+				{
+					ma_sound_uninit(&data->Sound);
+				}
+
+				FreeSound(contextData, soundID);
+			}
+
+			for (uint32_t groupIndex = 0; groupIndex < contextData->ActiveSoundGroups.Capacity(); groupIndex++)
+			{
+				ID groupID = contextData->ActiveSoundGroups.GetIDByIndex(groupIndex);
+
+				if (groupID != ID::Invalid && contextData->ActiveSoundGroups.Get(groupID)->Data.EngineID == engineID)
+				{
+					FreeSoundGroup(contextData, groupID);
+				}
+			}
+		}
+
+		// Pools left alone for a while give back what they grew past their warm count, one
+		// instance per update so a burst of frees doesn't land on a single frame
+		static void ShrinkSoundPools(InternalData* contextData, EngineInternalData* engineData)
+		{
+			auto now = std::chrono::steady_clock::now();
+
+			for (auto& [path, pool] : engineData->SoundPools)
+			{
+				if (pool.Idle.size() <= pool.Settings.WarmCount || now - pool.LastUsed < std::chrono::milliseconds(pool.Settings.ShrinkDelayInMilliseconds))
+				{
+					continue;
+				}
+
+				FreePooledSound(contextData, pool.Idle.back());
+				pool.Idle.pop_back();
+			}
+		}
+
+		// Catches the context thread's copy of a sound up with a play, stop or parameter change the sequencer made
+		static void MirrorFiredEvent(InternalData* contextData, EngineInternalData* engineData, const Command& command)
+		{
+			SoundInternalData* data = contextData->ActiveSounds.Get(command.Target);
+
+			if (data == nullptr)
+			{
+				return;
+			}
+
+			SoundSpatialStore& store = contextData->SoundSpatial;
+			uint32_t index = command.Target.GetIndex();
+
+			switch (command.Type)
+			{
+				case CommandType::SoundPlay:
+					data->Data.IsPaused = false;
+					data->Data.PausedByGroup = false;
+					store.SetFlag(index, SpatialFlag_Virtual, false);
+					store.SetFlag(index, SpatialFlag_Playing, true);
+
+					// Counted against the voice budget from now on, but never stole a voice to get in
+					if (!data->Data.IsVoiceTracked)
+					{
+						engineData->Data.Voices.push_back(command.Target);
+						data->Data.IsVoiceTracked = true;
+					}
+					break;
+				case CommandType::SoundStop:
+					data->Data.IsPaused = false;
+					store.SetFlag(index, SpatialFlag_Virtual, false);
+					store.SetFlag(index, SpatialFlag_Playing, false);
+					break;
+				case CommandType::SoundSetVolume: store.SetVolume(index, command.Floats[0]); break;
+				case CommandType::SoundSetPitch:  data->Data.Pitch = command.Floats[0]; break;
+				case CommandType::SoundSetPan:    data->Data.Pan = command.Floats[0]; break;
+				default:
+					break;
+			}
+		}
+
+		// Snapshot of an engine's listeners for the attenuation pass
+		static Attenuation::ListenerSet GetListenerSet(const EngineData& engine)
+		{
+			Attenuation::ListenerSet listeners;
+			listeners.Count = engine.ListenerCount;
+
+			for (uint32_t i = 0; i < engine.ListenerCount; i++)
+			{
+				const ListenerState& listener = engine.Listeners[i];
+				listeners.X[i] = listener.Position.X;
+				listeners.Y[i] = listener.Position.Y;
+				listeners.Z[i] = listener.Position.Z;
+				listeners.Enabled[i] = listener.Enabled;
+			}
+
+			return listeners;
+		}
+
+		// Applies the last batch of occlusion results once the worker is done with it, then hands the
+		// callback the next slice of playing sounds. Slices continue round-robin from where the last one
+		// stopped, so every sound gets checked once per cycle however many there are.
+		static void UpdateOcclusionQueries(InternalData* contextData, uint32_t engineIndex, EngineInternalData* engineData)
+		{
+			OcclusionBatch& batch = *engineData->Occlusion;
+
+			if (batch.Pending)
+			{
+				if (batch.InFlight.load(std::memory_order_acquire))
+				{
+					return;
+				}
+
+				for (size_t i = 0; i < batch.Queries.size(); i++)
+				{
+					// Sounds destroyed while the batch was out are simply skipped
+					if (contextData->ActiveSounds.Contains(batch.Queries[i].SoundID))
+					{
+						Sound(batch.Queries[i].SoundID).SetOcclusion(batch.Results[i]);
+					}
+				}
+
+				batch.Pending = false;
+			}
+
+			const OcclusionSettings& settings = engineData->Data.Occlusion;
+			auto now = std::chrono::steady_clock::now();
+
+			if (settings.QueryCallback == nullptr || settings.MaxQueriesPerBatch == 0 || now - batch.LastDispatch < std::chrono::milliseconds(settings.BatchIntervalInMilliseconds))
+			{
+				return;
+			}
+
+			SoundSpatialStore& store = contextData->SoundSpatial;
+			uint32_t soundCapacity = contextData->ActiveSounds.Capacity();
+			Attenuation::ListenerSet listeners = GetListenerSet(engineData->Data);
+
+			batch.Queries.clear();
+
+			uint32_t index = batch.Cursor < soundCapacity ? batch.Cursor : 0;
+
+			for (uint32_t scanned = 0; scanned < soundCapacity && batch.Queries.size() < settings.MaxQueriesPerBatch; scanned++, index = index + 1 < soundCapacity ? index + 1 : 0)
+			{
+				SoundSpatialStore::Page* page = store.GetPage(index / SoundSpatialStore::PageSize);
+
+				if (page == nullptr)
+				{
+					continue;
+				}
+
+				uint32_t lane = SoundSpatialStore::GetLane(index);
+				uint8_t flags = page->Flags[lane];
+
+				// Sounds positioned relative to the listener move with it, there's nothing to raycast
+				if ((flags & SpatialFlag_Active) == 0 || (flags & SpatialFlag_Playing) == 0 || page->EngineIndex[lane] != engineIndex || page->SpatialMask[lane] == 0.0f || page->AbsoluteMask[lane] == 0.0f)
+				{
+					continue;
+				}
+
+				ID soundID = contextData->ActiveSounds.GetIDByIndex(index);
+
+				if (soundID == ID::Invalid)
+				{
+					continue;
+				}
+
+				OcclusionQuery& query = batch.Queries.emplace_back();
+				query.SoundID = soundID;
+				query.SoundPosition = Vec3(page->PositionX[lane], page->PositionY[lane], page->PositionZ[lane]);
+
+				float pinned = page->PinnedListener[lane];
+				query.ListenerIndex = pinned >= 0.0f && (uint32_t)pinned < listeners.Count ? (uint32_t)pinned : Attenuation::FindClosestListener(listeners, query.SoundPosition);
+				query.ListenerPosition = engineData->Data.Listeners[query.ListenerIndex].Position;
+			}
+
+			batch.Cursor = index;
+			batch.LastDispatch = now;
+
+			if (batch.Queries.empty())
+			{
+				return;
+			}
+
+			// Unanswered queries leave their sound clear rather than reading stale results
+			batch.Results.assign(batch.Queries.size(), 0.0f);
+			batch.Pending = true;
+			batch.InFlight.store(true, std::memory_order_relaxed);
+
+			if (contextData->OcclusionQueries.GetThreadCount() == 0)
+			{
+				contextData->OcclusionQueries.Start(1);
+			}
+
+			contextData->OcclusionQueries.Submit([pBatch = &batch, callback = settings.QueryCallback, userData = settings.pUserData]()
+			{
+				callback(userData, pBatch->Queries.data(), pBatch->Results.data(), (uint32_t)pBatch->Queries.size());
+
+				pBatch->InFlight.store(false, std::memory_order_release);
+				pBatch->InFlight.notify_all();
+			});
+		}
+
+		// Whether any of the first 'laneCount' lanes of a page holds a playing sound of the engine
+		static bool HasPlayingLanes(const SoundSpatialStore::Page& page, uint32_t laneCount, uint32_t engineIndex)
+		{
+			for (uint32_t lane = 0; lane < laneCount; lane++)
+			{
+				if ((page.Flags[lane] & SpatialFlag_Active) != 0 && (page.Flags[lane] & SpatialFlag_Playing) != 0 && page.EngineIndex[lane] == engineIndex)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		static void VirtualizeVoice(ma_sound* sound, SoundData& data)
+		{
+			ma_uint64 cursor = 0;
+			ma_sound_get_cursor_in_pcm_frames(sound, &cursor);
+
+			data.VirtualCursorInPCMFrames = cursor;
+			data.VirtualStartTimeInPCMFrames = ma_engine_get_time_in_pcm_frames(ma_sound_get_engine(sound));
+
+			ma_sound_stop(sound);
+		}
+
+		static bool StoreLane(float* x, float* y, float* z, uint32_t lane, const Vec3& value)
+		{
+			if (x[lane] == value.X && y[lane] == value.Y && z[lane] == value.Z)
+			{
+				return false;
+			}
+
+			x[lane] = value.X;
+			y[lane] = value.Y;
+			z[lane] = value.Z;
+
+			return true;
+		}
+
+		// Stops the context's threads, unpublishes its index and frees its state. Used by Shutdown
+		// and to unwind a failed Init, so the same context can be initialized again.
+		static void FreeContextData(InternalData* contextData)
+		{
+			contextData->SoundLoader.Stop();
+			contextData->OcclusionQueries.Stop();
+
+			s_Contexts[contextData->ContextIndex].store(nullptr, std::memory_order_release);
+
+			// Copied out, the allocator can't free the object it lives in
+			Allocator allocator = contextData->Memory;
+			allocator.Delete(contextData);
+		}
+
+	}
+
+	ContextResult Context::Init(const ContextSettings& settings)
+	{
+		ContextResult result;
+		result.Success = false;
+
+		WAVE_ASSERT(m_Data == nullptr, "Trying to initialize a context multiple times!%s", "");
+
+		// Claim a context index, handles carry it so static lookups find this context's state
+		{
+			std::scoped_lock<std::mutex> lock(s_ContextsMutex);
+
+			uint32_t contextIndex = 0;
+			while (contextIndex < ID::MaxContexts && s_Contexts[contextIndex].load(std::memory_order_relaxed) != nullptr)
+			{
+				contextIndex++;
+			}
+
+			if (contextIndex == ID::MaxContexts)
+			{
+				SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "contexts");
+				return result;
+			}
+
+			if (!Allocator::IsComplete(settings.Allocation) && (settings.Allocation.Malloc != nullptr || settings.Allocation.Realloc != nullptr || settings.Allocation.Free != nullptr))
+			{
+				SetLastError(ErrorCode::InvalidSettings, ID::Invalid, 0, 0, "allocation callbacks need Malloc, Realloc and Free to all be set");
+				return result;
+			}
+
+			// The context's own state comes out of the callbacks too
+			Allocator allocator(settings.Allocation);
+			m_Data = allocator.New<InternalData>(settings.Allocation);
+
+			if (m_Data == nullptr)
+			{
+				SetLastError(ErrorCode::OutOfMemory, ID::Invalid, 0, 0, "initializing the context");
+				return result;
+			}
+
+			m_Data->ContextIndex = contextIndex;
+			m_Data->ActiveSounds.SetContextIndex(contextIndex);
+			m_Data->ActiveSoundGroups.SetContextIndex(contextIndex);
+			m_Data->ActiveEngines.SetContextIndex(contextIndex);
+			m_Data->ActiveOneShotPools.SetContextIndex(contextIndex);
+			s_Contexts[contextIndex].store(m_Data, std::memory_order_release);
+		}
+
+		m_Data->CurrentContext.pCtx = this;
+
+		bool reserved = m_Data->ActiveSounds.Reserve(settings.ReservedSounds) && m_Data->SoundSpatial.Reserve(settings.ReservedSounds);
+		reserved = reserved && m_Data->ActiveSoundGroups.Reserve(settings.ReservedSoundGroups);
+		reserved = reserved && m_Data->ActiveEngines.Reserve(settings.ReservedEngines);
+
+		if (!reserved)
+		{
+			SetLastError(ErrorCode::OutOfMemory, ID::Invalid, 0, 0, "reserving slots");
+			Utils::FreeContextData(m_Data);
+			m_Data = nullptr;
+			return result;
+		}
+
+		m_Data->UpdateBatch.Reserve(settings.ReservedSounds);
+		m_Data->DecodedSounds.SetBudget(settings.DecodedCacheBudget);
+		m_Data->StreamingThreshold = settings.StreamingThreshold;
+		m_Data->SoundLoader.Start(settings.LoaderThreadCount);
+		m_Data->DeferCommands = settings.DeferCommands;
+
+		if (!m_Data->Commands.Init(settings.CommandQueueCapacity, &m_Data->Memory))
+		{
+			SetLastError(ErrorCode::OutOfMemory, ID::Invalid, settings.CommandQueueCapacity, 0, "allocating the command queue");
+			Utils::FreeContextData(m_Data);
+			m_Data = nullptr;
+			return result;
+		}
+
+		// Initialize Miniaudio
+		ma_context_config config = ma_context_config_init();
+		config.pUserData = settings.pUserData;
+		config.allocationCallbacks = m_Data->MiniaudioCallbacks;
+
+		ma_result res = ma_context_init(nullptr, 0, &config, &m_Data->CurrentContext.Data.Context);
+		
+		if (res != MA_SUCCESS)
+		{
+			SetLastError(ErrorCode::BackendFailed, ID::Invalid, 0, 0, "initialize");
+			Utils::FreeContextData(m_Data);
+			m_Data = nullptr;
+			return result;
+		}
+
+		res = ma_context_get_devices(
+			&m_Data->CurrentContext.Data.Context,
+			&m_Data->CurrentContext.Data.PlaybackDeviceInfos,
+			&m_Data->CurrentContext.Data.PlaybackDeviceCount,
+			&m_Data->CurrentContext.Data.CaptureDeviceInfos,
+			&m_Data->CurrentContext.Data.CaptureDeviceCount
+		);
+		
+		if (res != MA_SUCCESS)
+		{
+			SetLastError(ErrorCode::BackendFailed, ID::Invalid, 0, 0, "enumerate hardware devices");
+			ma_context_uninit(&m_Data->CurrentContext.Data.Context);
+			Utils::FreeContextData(m_Data);
+			m_Data = nullptr;
+			return result;
+		}
+
+		if (settings.EnableDebugLogging)
+		{
+			ma_log* log = ma_context_get_log(&m_Data->CurrentContext.Data.Context);
+			
+			ma_log_callback callback;
+			callback.onLog = settings.LogCallback;
+
+			res = ma_log_register_callback(log, callback);
+			
+			if (res != MA_SUCCESS)
+			{
+				SetLastError(ErrorCode::BackendFailed, ID::Invalid, 0, 0, "register the log callback");
+				ma_context_uninit(&m_Data->CurrentContext.Data.Context);
+				Utils::FreeContextData(m_Data);
+				m_Data = nullptr;
+				return result;
+			}
+		}
+
+		if (settings.EnumerateDevices)
+		{
+			DeviceInfo deviceInfo = {};
+
+			for (uint32_t i = 0; i < m_Data->CurrentContext.Data.PlaybackDeviceCount; i++)
+			{
+				deviceInfo.Name = std::string(m_Data->CurrentContext.Data.PlaybackDeviceInfos[i].name);
+				deviceInfo.Type = DeviceType::Playback;
+				deviceInfo.IsDefault = (bool)m_Data->CurrentContext.Data.PlaybackDeviceInfos[i].isDefault;
+				deviceInfo.Index = i;
+				result.PlaybackDeviceInfos.push_back(deviceInfo);
+			}
+
+			for (uint32_t i = 0; i < m_Data->CurrentContext.Data.CaptureDeviceCount; i++)
+			{
+				deviceInfo.Name = std::string(m_Data->CurrentContext.Data.CaptureDeviceInfos[i].name);
+				deviceInfo.Type = DeviceType::Capture;
+				deviceInfo.IsDefault = (bool)m_Data->CurrentContext.Data.CaptureDeviceInfos[i].isDefault;
+				deviceInfo.Index = i;
+				result.CaptureDeviceInfos.push_back(deviceInfo);
+			}
+		}
+
+		result.Success = true;
+		return result;
+	}
+
+	bool Context::Shutdown()
+	{
+		WAVE_ASSERT(m_Data != nullptr, "Trying to shutdown a context without initializing it!%s", "");
+
+		// Let any in-flight loads and occlusion queries finish before the engines go away
+		m_Data->SoundLoader.Stop();
+		m_Data->OcclusionQueries.Stop();
+
+		// Engines playing through a device keep calling back into their state until the device is
+		// uninitialized, so every engine is torn down before the state is freed. Sounds, groups and
+		// one-shot pools go with their engine.
+		for (uint32_t engineIndex = 0; engineIndex < m_Data->ActiveEngines.Capacity(); engineIndex++)
+		{
+			ID engineID = m_Data->ActiveEngines.GetIDByIndex(engineIndex);
+
+			if (engineID != ID::Invalid)
+			{
+				DestroyEngine(engineID);
+			}
+		}
+
+		// Shutdown Miniaudio
+		ma_context* context = &m_Data->CurrentContext.Data.Context;
+		ma_result res = ma_context_uninit(context);
+		
+		if (res != MA_SUCCESS)
+		{
+			SetLastError(ErrorCode::BackendFailed, ID::Invalid, 0, 0, "shut down");
+			return false;
+		}
+
+		Utils::FreeContextData(m_Data);
+		m_Data = nullptr;
+
+		return true;
+	}
+
+	Sound Context::CreateSoundFromFile(ID engineID, const std::filesystem::path& path, SoundLoadMode mode, ID groupID)
+	{
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid Engine ID: '%zu'", uint64_t(engineID));
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return Sound(ID::Invalid);
+		}
+
+		if (!Utils::CheckSoundGroup(m_Data, engineID, groupID))
+		{
+			return Sound(ID::Invalid);
+		}
+
+		// A pooled file skips the load entirely when an idle instance is around
+		if (mode != SoundLoadMode::Stream && !engineData->SoundPools.empty())
+		{
+			ID pooledID = Utils::TakePooledSound(m_Data, engineID, engineData, path.string());
+
+			if (pooledID != ID::Invalid)
+			{
+				SoundInternalData* data = m_Data->ActiveSounds.Get(pooledID);
+				data->Data.GroupID = groupID;
+				Utils::AttachSoundToGroup(m_Data, pooledID, data);
+
+				return Sound(pooledID);
+			}
+		}
+
+		ID soundID = Utils::AllocateSound(m_Data, engineID);
+
+		if (soundID == ID::Invalid)
+		{
+			SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "sounds");
+			return Sound(ID::Invalid);
+		}
+
+		SoundInternalData* data = m_Data->ActiveSounds.Get(soundID);
+
+		if (!Utils::LoadSoundFromFile(m_Data, soundID, &engineData->Engine, data, path.string(), mode))
+		{
+			Utils::FreeSound(m_Data, soundID);
+			return Sound(ID::Invalid);
+		}
+
+		data->Data.GroupID = groupID;
+		Utils::AttachSoundToGroup(m_Data, soundID, data);
+
+		return Sound(soundID);
+	}
+
+	Sound Context::CreateSoundFromFileAsync(ID engineID, const std::filesystem::path& path, SoundLoadMode mode, SoundLoadedCallback callback, void* userData, ID groupID)
+	{
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid Engine ID: '%zu'", uint64_t(engineID));
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return Sound(ID::Invalid);
+		}
+
+		if (!Utils::CheckSoundGroup(m_Data, engineID, groupID))
+		{
+			return Sound(ID::Invalid);
+		}
+
+		ID soundID = Utils::AllocateSound(m_Data, engineID);
+
+		if (soundID == ID::Invalid)
+		{
+			SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "sounds");
+			return Sound(ID::Invalid);
+		}
+
+		SoundInternalData* data = m_Data->ActiveSounds.Get(soundID);
+		data->Data.LoadState = SoundLoadState::Loading;
+		data->Data.GroupID = groupID; // Routed once loaded, see PublishLoadedSounds
+		data->LoadedCallback = callback;
+		data->LoadedUserData = userData;
+
+		// Slots and engines never move, so the loader can hold on to the pointers. DestroyEngine
+		// waits for the engine's loads to drain before it tears the engine down.
+		ma_engine* engine = &engineData->Engine;
+		EngineLoads* loads = engineData->Loads.get();
+		loads->InFlight.fetch_add(1, std::memory_order_relaxed);
+
+		m_Data->SoundLoader.Submit([contextData = m_Data, soundID, engineID, engine, loads, data, mode, filepath = path.string()]()
+		{
+			SoundLoadResult result;
+			result.SoundID = soundID;
+
+			if (loads->Cancelled.load(std::memory_order_acquire))
+			{
+				SetLastError(ErrorCode::InvalidEngine, engineID);
+			}
+			else
+			{
+				result.Success = Utils::LoadSoundFromFile(contextData, soundID, engine, data, filepath, mode);
+			}
+
+			if (!result.Success)
+			{
+				result.Error = GetLastError();
+			}
+
+			{
+				std::scoped_lock<std::mutex> lock(contextData->LoadedSoundsMutex);
+				contextData->LoadedSounds.push_back(std::move(result));
+			}
+
+			// Last touch of the engine, DestroyEngine may free it as soon as this drops to zero
+			if (loads->InFlight.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				loads->InFlight.notify_all();
+			}
+		});
+
+		return Sound(soundID);
+	}
+
+	Sound Context::CreateSoundFromDataSource(ID engineID, const uint8_t* src, size_t size, ID groupID)
+	{
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid Engine ID: '%zu'", uint64_t(engineID));
+		WAVE_ASSERT(src != nullptr && size != 0, "Data source must not be empty!%s", "");
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return Sound(ID::Invalid);
+		}
+
+		if (!Utils::CheckSoundGroup(m_Data, engineID, groupID))
+		{
+			return Sound(ID::Invalid);
+		}
+
+		ID soundID = Utils::AllocateSound(m_Data, engineID);
+
+		if (soundID == ID::Invalid)
+		{
+			SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "sounds");
+			return Sound(ID::Invalid);
+		}
+
+		SoundInternalData* data = m_Data->ActiveSounds.Get(soundID);
+
+		// The decoder reads straight out of the caller's buffer, nothing is copied
+		data->Decoder = m_Data->Memory.New<ma_decoder>();
+		ma_decoder_config decoderConfig = ma_decoder_config_init(ma_format_f32, 0, 0);
+		decoderConfig.allocationCallbacks = m_Data->MiniaudioCallbacks;
+
+		ma_result res = data->Decoder != nullptr ? ma_decoder_init_memory(src, size, &decoderConfig, data->Decoder) : MA_OUT_OF_MEMORY;
+
+		if (res != MA_SUCCESS)
+		{
+			m_Data->Memory.Delete(data->Decoder);
+			data->Decoder = nullptr;
+			Utils::FreeSound(m_Data, soundID);
+			SetLastError(ErrorCode::DataSourceFailed, ID::Invalid, size);
+			return Sound(ID::Invalid);
+		}
+
+		ma_sound_config config = ma_sound_config_init();
+		config.pDataSource = data->Decoder;
+
+		res = ma_sound_init_ex(&engineData->Engine, &config, &data->Sound);
+
+		if (res != MA_SUCCESS)
+		{
+			Utils::FreeSound(m_Data, soundID);
+			SetLastError(ErrorCode::DataSourceFailed, ID::Invalid, size);
+			return Sound(ID::Invalid);
+		}
+
+		if (!Utils::QuerySoundInfo(soundID, data))
+		{
+			Utils::FreeSound(m_Data, soundID);
+			return Sound(ID::Invalid);
+		}
+
+		data->Data.GroupID = groupID;
+		Utils::AttachSoundToGroup(m_Data, soundID, data);
+
+		return Sound(soundID);
+	}
+
+	Sound Context::CreateSoundFromBank(ID engineID, const SoundBank& bank, uint64_t nameHash, ID groupID)
+	{
+		WAVE_ASSERT(bank.IsOpen(), "Sound bank is not open!%s", "");
+
+		const SoundBankEntry* entry = bank.Find(nameHash);
+
+		if (entry == nullptr)
+		{
+			SetLastError(ErrorCode::BankEntryNotFound, ID::Invalid, nameHash);
+			return Sound(ID::Invalid);
+		}
+
+		if (entry->Codec == SoundBankCodec::Encoded)
+		{
+			return CreateSoundFromDataSource(engineID, bank.GetPayload(*entry), entry->Length, groupID);
+		}
+
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid Engine ID: '%zu'", uint64_t(engineID));
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return Sound(ID::Invalid);
+		}
+
+		if (!Utils::CheckSoundGroup(m_Data, engineID, groupID))
+		{
+			return Sound(ID::Invalid);
+		}
+
+		ID soundID = Utils::AllocateSound(m_Data, engineID);
+
+		if (soundID == ID::Invalid)
+		{
+			SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "sounds");
+			return Sound(ID::Invalid);
+		}
+
+		SoundInternalData* data = m_Data->ActiveSounds.Get(soundID);
+
+		// Raw PCM needs no decoding, the buffer ref reads frames straight out of the mapping
+		ma_format format = entry->Codec == SoundBankCodec::PCMS16 ? ma_format_s16 : ma_format_f32;
+		ma_result res = Utils::InitSoundFromFrames(m_Data, &engineData->Engine, data, format, entry->Channels, entry->SampleRate, bank.GetPayload(*entry), entry->LengthInPCMFrames);
+
+		if (res != MA_SUCCESS)
+		{
+			Utils::FreeSound(m_Data, soundID);
+			SetLastError(ErrorCode::BankEntryFailed, ID::Invalid, nameHash);
+			return Sound(ID::Invalid);
+		}
+
+		if (!Utils::QuerySoundInfo(soundID, data))
+		{
+			Utils::FreeSound(m_Data, soundID);
+			return Sound(ID::Invalid);
+		}
+
+		data->Data.GroupID = groupID;
+		Utils::AttachSoundToGroup(m_Data, soundID, data);
+
+		return Sound(soundID);
+	}
+
+	Sound Context::CreateSoundFromBank(ID engineID, const SoundBank& bank, std::string_view name, ID groupID)
+	{
+		Sound sound = CreateSoundFromBank(engineID, bank, SoundBank::HashName(name), groupID);
+
+		if (sound.GetID() == ID::Invalid && bank.Find(name) == nullptr)
+		{
+			SetLastError(ErrorCode::BankEntryNotFound, ID::Invalid, 0, 0, name);
+		}
+
+		return sound;
+	}
+
+	bool Context::PreloadSound(const std::filesystem::path& path)
+	{
+		return m_Data->DecodedSounds.Preload(path.string());
+	}
+
+	bool Context::UnloadSound(const std::filesystem::path& path)
+	{
+		if (!m_Data->DecodedSounds.Unload(path.string()))
+		{
+			SetLastError(ErrorCode::NotPreloaded, ID::Invalid, 0, 0, path.string());
+			return false;
+		}
+
+		return true;
+	}
+
+	void Context::SetDecodedCacheBudget(size_t budgetInBytes)
+	{
+		m_Data->DecodedSounds.SetBudget(budgetInBytes);
+	}
+
+	DecodedCacheStats Context::GetDecodedCacheStats() const
+	{
+		return m_Data->DecodedSounds.GetStats();
+	}
+
+	bool Context::DestroySound(ID id)
+	{
+		if (DeferResult deferred = DeferCommand(MakeCommand(CommandType::SoundDestroy, id)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		SoundInternalData* data = m_Data->ActiveSounds.Get(id);
+		
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidSound, id);
+			return false;
+		}
+
+		switch (data->Data.LoadState)
+		{
+			case SoundLoadState::Loading:
+				// The loader still owns the slot, Update frees it once the load is done
+				data->Data.DestroyPending = true;
+				data->Data.PlayPending = false;
+				return true;
+			case SoundLoadState::Loaded:
+			{
+				if (Utils::ParkPooledSound(m_Data, id, data))
+				{
+					return true;
+				}
+
+				// The audio thread may be applying a scheduled event to this very sound
+				std::unique_lock<std::mutex> lock = Utils::LockSequencer(m_Data, id);
+				ma_sound_uninit(&data->Sound);
+				break;
+			}
+			case SoundLoadState::Failed:
+				break;
+		}
+
+		Utils::FreeSound(m_Data, id);
+
+		return true;
+	}
+
+    SoundGroup Context::CreateSoundGroup(ID engineID, ID parentGroupID)
+    {
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid Engine ID: '%zu'", uint64_t(engineID));
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return SoundGroup(ID::Invalid);
+		}
+
+		ma_sound_group* parentGroup = nullptr;
+
+		if (parentGroupID != ID::Invalid)
+		{
+			SoundGroupInternalData* parentData = m_Data->ActiveSoundGroups.Get(parentGroupID);
+			WAVE_ASSERT(parentData != nullptr, "Invalid Sound Group ID: '%zu'", uint64_t(parentGroupID));
+
+			if (parentData == nullptr)
+			{
+				SetLastError(ErrorCode::InvalidSoundGroup, parentGroupID);
+				return SoundGroup(ID::Invalid);
+			}
+
+			if (parentData->Data.EngineID != engineID)
+			{
+				SetLastError(ErrorCode::GroupEngineMismatch, parentGroupID);
+				return SoundGroup(ID::Invalid);
+			}
+
+			parentGroup = &parentData->Group;
+		}
+
+		ID soundGroupID = m_Data->ActiveSoundGroups.Insert();
+
+		if (soundGroupID == ID::Invalid)
+		{
+			SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "sound groups");
+			return SoundGroup(ID::Invalid);
+		}
+
+		SoundGroupInternalData* data = m_Data->ActiveSoundGroups.Get(soundGroupID);
+		data->Effects = AllocatedVector<AllocatedPtr<BusEffectNode>>(&m_Data->Memory);
+
+		ma_result res = ma_sound_group_init(&engineData->Engine, 0, parentGroup, &data->Group);
+
+		if (res != MA_SUCCESS)
+		{
+			m_Data->ActiveSoundGroups.Remove(soundGroupID);
+			SetLastError(ErrorCode::SoundGroupInitFailed);
+			return SoundGroup(ID::Invalid);
+		}
+
+		// Matches the SoundGroupData default, members are spatialized on their own
+		ma_sound_group_set_spatialization_enabled(&data->Group, MA_FALSE);
+
+		data->Data.EngineID = engineID;
+		data->Data.ParentGroupID = parentGroupID;
+
+		if (parentGroupID != ID::Invalid)
+		{
+			m_Data->ActiveSoundGroups.Get(parentGroupID)->Data.Children.push_back(soundGroupID);
+		}
+
+        return SoundGroup(soundGroupID);
+    }
+
+    bool Context::DestroySoundGroup(ID id)
+    {
+		if (DeferResult deferred = DeferCommand(MakeCommand(CommandType::SoundGroupDestroy, id)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		SoundGroupInternalData* data = m_Data->ActiveSoundGroups.Get(id);
+
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidSoundGroup, id);
+			return false;
+		}
+
+		// Hand every member over to the parent (or the engine) so nothing goes silent
+		ID parentGroupID = data->Data.ParentGroupID;
+		SoundGroupInternalData* parentData = parentGroupID != ID::Invalid ? m_Data->ActiveSoundGroups.Get(parentGroupID) : nullptr;
+		ma_node* output = Utils::GetGroupOutput(m_Data, data);
+
+		if (parentData == nullptr)
+		{
+			parentGroupID = ID::Invalid;
+		}
+
+		Utils::PruneGroupMembers(m_Data, id, data->Data);
+
+		for (ID soundID : data->Data.Sounds)
+		{
+			SoundInternalData* sound = m_Data->ActiveSounds.Get(soundID);
+
+			ma_node_attach_output_bus(Utils::GetSoundTail(sound), 0, output, 0);
+			sound->Data.GroupID = parentGroupID;
+
+			if (parentData != nullptr)
+			{
+				parentData->Data.Sounds.push_back(soundID);
+			}
+		}
+
+		for (ID childID : data->Data.Children)
+		{
+			SoundGroupInternalData* child = m_Data->ActiveSoundGroups.Get(childID);
+
+			ma_node_attach_output_bus(Utils::GetGroupTail(child), 0, output, 0);
+			child->Data.ParentGroupID = parentGroupID;
+
+			if (parentData != nullptr)
+			{
+				parentData->Data.Children.push_back(childID);
+			}
+		}
+
+		// Sounds still loading into the group end up on the engine, see AttachSoundToGroup
+		Utils::FreeSoundGroup(m_Data, id);
+
+		return true;
+    }
+
+	Engine Context::CreateEngine(const EngineSettings& settings)
+	{
+		ID engineID = m_Data->ActiveEngines.Insert();
+
+		if (engineID == ID::Invalid)
+		{
+			SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "engines");
+			return Engine(ID::Invalid);
+		}
+
+		EngineInternalData* data = m_Data->ActiveEngines.Get(engineID);
+
+		ma_engine_config config = ma_engine_config_init();
+		config.allocationCallbacks = m_Data->MiniaudioCallbacks;
+		config.noAutoStart = true;
+		config.listenerCount = std::clamp<uint32_t>(settings.ListenerCount, 1, MaxListeners);
+
+		if (settings.Offline)
+		{
+			// Without a device miniaudio can't pick a format, so offline engines need one spelled out
+			config.noDevice = true;
+			config.channels = settings.Channels != 0 ? settings.Channels : 2;
+			config.sampleRate = settings.SampleRate != 0 ? settings.SampleRate : 48000;
+		}
+		else
+		{
+			// Set up the device the same way miniaudio would, only with our callback in front of the mix
+			ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+			deviceConfig.playback.format = ma_format_f32;
+			deviceConfig.playback.channels = settings.Channels;
+			deviceConfig.playback.shareMode = settings.Mode == ShareMode::Exclusive ? ma_share_mode_exclusive : ma_share_mode_shared;
+			deviceConfig.sampleRate = settings.SampleRate;
+			deviceConfig.periodSizeInFrames = settings.PeriodSizeInFrames;
+			deviceConfig.periods = settings.Periods;
+			deviceConfig.performanceProfile = settings.Profile == PerformanceProfile::Conservative ? ma_performance_profile_conservative : ma_performance_profile_low_latency;
+			deviceConfig.dataCallback = Utils::EngineDataCallback;
+			deviceConfig.pUserData = data;
+			deviceConfig.noPreSilencedOutputBuffer = MA_TRUE;
+			deviceConfig.noClip = MA_TRUE;
+
+			const ContextInternalData& contextData = m_Data->CurrentContext.Data;
+
+			if (settings.PlaybackDeviceIndex >= 0)
+			{
+				if ((uint32_t)settings.PlaybackDeviceIndex >= contextData.PlaybackDeviceCount)
+				{
+					m_Data->ActiveEngines.Remove(engineID);
+					SetLastError(ErrorCode::DeviceIndexOutOfRange, ID::Invalid, (uint64_t)(int64_t)settings.PlaybackDeviceIndex, contextData.PlaybackDeviceCount);
+					return Engine(ID::Invalid);
+				}
+
+				deviceConfig.playback.pDeviceID = &contextData.PlaybackDeviceInfos[settings.PlaybackDeviceIndex].id;
+			}
+
+			if (ma_device_init(&m_Data->CurrentContext.Data.Context, &deviceConfig, &data->Device) != MA_SUCCESS)
+			{
+				const char* deviceName = deviceConfig.playback.pDeviceID != nullptr ? contextData.PlaybackDeviceInfos[settings.PlaybackDeviceIndex].name : "default";
+
+				m_Data->ActiveEngines.Remove(engineID);
+				SetLastError(ErrorCode::DeviceOpenFailed, ID::Invalid, settings.Mode == ShareMode::Exclusive, 0, deviceName);
+				return Engine(ID::Invalid);
+			}
+
+			data->HasDevice = true;
+			config.pDevice = &data->Device;
+		}
+		
+		ma_result res = ma_engine_init(&config, &data->Engine);
+		
+		if (res != MA_SUCCESS)
+		{
+			if (data->HasDevice)
+			{
+				ma_device_uninit(&data->Device);
+			}
+
+			m_Data->ActiveEngines.Remove(engineID);
+			SetLastError(ErrorCode::EngineInitFailed);
+			return Engine(ID::Invalid);
+		}
+
+		data->Data.IsOffline = settings.Offline;
+		data->Data.ListenerCount = ma_engine_get_listener_count(&data->Engine);
+		data->Profiler = MakeAllocated<CallbackProfiler>(m_Data->Memory, ma_engine_get_sample_rate(&data->Engine), !settings.Offline, settings.CallbackTraceCapacity, &m_Data->Memory);
+		data->Occlusion = MakeAllocated<OcclusionBatch>(m_Data->Memory, &m_Data->Memory);
+		data->Loads = MakeAllocated<EngineLoads>(m_Data->Memory);
+		data->SoundPools = decltype(data->SoundPools)(StlAllocator<decltype(data->SoundPools)::value_type>(&m_Data->Memory));
+		data->ContextData = m_Data;
+
+		if (settings.SequencerCapacity != 0)
+		{
+			data->Events = MakeAllocated<Sequencer>(m_Data->Memory, settings.SequencerCapacity, &m_Data->Memory);
+		}
+
+		// The data callback and Update use all of these without checking, so an engine missing any is torn down again
+		bool allocated = data->Profiler != nullptr && data->Profiler->IsInitialized() && data->Occlusion != nullptr && data->Loads != nullptr;
+		allocated = allocated && (settings.SequencerCapacity == 0 || (data->Events != nullptr && data->Events->IsInitialized()));
+
+		if (!allocated)
+		{
+			if (data->HasDevice)
+			{
+				ma_device_uninit(&data->Device);
+			}
+
+			ma_engine_uninit(&data->Engine);
+			data->Profiler.reset();
+			data->Occlusion.reset();
+			data->Loads.reset();
+			data->Events.reset();
+
+			m_Data->ActiveEngines.Remove(engineID);
+			SetLastError(ErrorCode::OutOfMemory, ID::Invalid, 0, 0, "creating an engine");
+			return Engine(ID::Invalid);
+		}
+
+		return Engine(engineID);
+	}
+
+	bool Context::DestroyEngine(ID id)
+	{
+		EngineInternalData* data = m_Data->ActiveEngines.Get(id);
+		
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, id);
+			return false;
+		}
+
+		// The occlusion worker may still be writing into the engine's batch
+		data->Occlusion->InFlight.wait(true, std::memory_order_acquire);
+
+		// Queued loads are dropped, the ones already running against the engine are waited for
+		data->Loads->Cancelled.store(true, std::memory_order_release);
+
+		for (uint32_t pending = data->Loads->InFlight.load(std::memory_order_acquire); pending != 0; pending = data->Loads->InFlight.load(std::memory_order_acquire))
+		{
+			data->Loads->InFlight.wait(pending, std::memory_order_acquire);
+		}
+
+		// The device goes first so the callback can't run against a torn down engine
+		if (data->HasDevice)
+		{
+			ma_device_uninit(&data->Device);
+		}
+
+		// Engine slots are reused, anything left behind would be picked up by the next engine in this one
+		Utils::FreeEngineObjects(m_Data, id, data);
+
+		ma_engine_uninit(&data->Engine);
+		data->Profiler.reset();
+		data->Occlusion.reset();
+		data->Loads.reset();
+		data->Events.reset();
+
+		m_Data->ActiveEngines.Remove(id);
+
+		return true;
+	}
+
+	bool Context::CreateSoundPool(ID engineID, const std::filesystem::path& path, const SoundPoolSettings& settings)
+	{
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid Engine ID: '%zu'", uint64_t(engineID));
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return false;
+		}
+
+		if (settings.WarmCount > settings.MaxIdle)
+		{
+			SetLastError(ErrorCode::InvalidSettings, engineID, settings.WarmCount, settings.MaxIdle, "sound pool warm count exceeds its max idle count");
+			return false;
+		}
+
+		std::string filepath = path.string();
+		auto [it, inserted] = engineData->SoundPools.try_emplace(filepath);
+
+		if (!inserted)
+		{
+			SetLastError(ErrorCode::SoundPoolExists, engineID, 0, 0, filepath);
+			return false;
+		}
+
+		SoundPool& pool = it->second;
+		pool.Settings = settings;
+		pool.Idle = AllocatedVector<ID>(&m_Data->Memory);
+		pool.Idle.reserve(settings.MaxIdle);
+		pool.LastUsed = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < settings.WarmCount; i++)
+		{
+			ID soundID = Utils::AllocateSound(m_Data, engineID);
+
+			if (soundID == ID::Invalid)
+			{
+				SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "sounds");
+				DestroySoundPool(engineID, path);
+				return false;
+			}
+
+			SoundInternalData* data = m_Data->ActiveSounds.Get(soundID);
+
+			if (!Utils::LoadSoundFromFile(m_Data, soundID, &engineData->Engine, data, filepath, SoundLoadMode::Decode))
+			{
+				Utils::FreeSound(m_Data, soundID);
+				DestroySoundPool(engineID, path);
+				return false;
+			}
+
+			// Only instances sharing the cache's buffer are cheap enough to keep around
+			if (data->CachedAsset == nullptr)
+			{
+				ma_sound_uninit(&data->Sound);
+				Utils::FreeSound(m_Data, soundID);
+				DestroySoundPool(engineID, path);
+				SetLastError(ErrorCode::TooLargeForCache, engineID, 0, 0, filepath);
+				return false;
+			}
+
+			Utils::ParkPooledSound(m_Data, soundID, data);
+		}
+
+		return true;
+	}
+
+	bool Context::DestroySoundPool(ID engineID, const std::filesystem::path& path)
+	{
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return false;
+		}
+
+		auto it = engineData->SoundPools.find(path.string());
+
+		if (it == engineData->SoundPools.end())
+		{
+			SetLastError(ErrorCode::SoundPoolNotFound, engineID, 0, 0, path.string());
+			return false;
+		}
+
+		// Sounds handed out by the pool stay alive, they're just freed normally once destroyed
+		for (ID parkedID : it->second.Idle)
+		{
+			Utils::FreePooledSound(m_Data, parkedID);
+		}
+
+		engineData->SoundPools.erase(it);
+
+		return true;
+	}
+
+	SoundPoolStats Context::GetSoundPoolStats(ID engineID, const std::filesystem::path& path) const
+	{
+		SoundPoolStats stats;
+		const EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+
+		if (engineData == nullptr)
+		{
+			return stats;
+		}
+
+		auto it = engineData->SoundPools.find(path.string());
+
+		if (it != engineData->SoundPools.end())
+		{
+			stats.Idle = (uint32_t)it->second.Idle.size();
+			stats.Hits = it->second.Hits;
+			stats.Misses = it->second.Misses;
+		}
+
+		return stats;
+	}
+
+	ID Context::CreateOneShotPool(ID engineID, const std::filesystem::path& path, uint32_t voiceCount, ID groupID)
+	{
+		EngineInternalData* engineData = m_Data->ActiveEngines.Get(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid Engine ID: '%zu'", uint64_t(engineID));
+
+		if (engineData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, engineID);
+			return ID::Invalid;
+		}
+
+		if (!Utils::CheckSoundGroup(m_Data, engineID, groupID))
+		{
+			return ID::Invalid;
+		}
+
+		if (voiceCount == 0)
+		{
+			SetLastError(ErrorCode::InvalidSettings, engineID, 0, 0, "one-shot pools need at least one voice");
+			return ID::Invalid;
+		}
+
+		ID poolID = m_Data->ActiveOneShotPools.Insert();
+
+		if (poolID == ID::Invalid)
+		{
+			SetLastError(ErrorCode::OutOfSlots, ID::Invalid, 0, 0, "one-shot pools");
+			return ID::Invalid;
+		}
+
+		AllocatedPtr<OneShotPool>& pool = *m_Data->ActiveOneShotPools.Get(poolID);
+		pool = MakeAllocated<OneShotPool>(m_Data->Memory);
+
+		if (pool == nullptr)
+		{
+			SetLastError(ErrorCode::OutOfMemory, engineID, 0, 0, "creating a one-shot pool");
+			m_Data->ActiveOneShotPools.Remove(poolID);
+			return ID::Invalid;
+		}
+
+		pool->EngineID = engineID;
+
+		// One-shots are short and restarted constantly, so they're always played from memory
+		bool tooLarge = false;
+		pool->Asset = m_Data->DecodedSounds.Acquire(path.string(), SIZE_MAX, &tooLarge);
+
+		if (pool->Asset == nullptr)
+		{
+			Utils::FreeOneShotPool(m_Data, poolID);
+			return ID::Invalid;
+		}
+
+		SoundGroupInternalData* group = groupID != ID::Invalid ? m_Data->ActiveSoundGroups.Get(groupID) : nullptr;
+		const DecodedSoundCache::Asset* asset = pool->Asset;
+
+		pool->Voices = m_Data->Memory.NewArray<OneShotVoice>(voiceCount);
+
+		if (pool->Voices == nullptr)
+		{
+			SetLastError(ErrorCode::OutOfMemory, engineID, voiceCount, 0, "creating one-shot voices");
+			Utils::FreeOneShotPool(m_Data, poolID);
+			return ID::Invalid;
+		}
+
+		pool->VoiceCount = voiceCount;
+
+		for (uint32_t i = 0; i < voiceCount; i++)
+		{
+			OneShotVoice& voice = pool->Voices[i];
+			voice.Pool = pool.get();
+			voice.Index = i;
+
+			ma_result res = ma_audio_buffer_ref_init(ma_format_f32, asset->Channels, asset->Frames, asset->FrameCount, &voice.Buffer);
+
+			if (res == MA_SUCCESS)
+			{
+				voice.Buffer.sampleRate = asset->SampleRate;
+
+				ma_sound_config config = ma_sound_config_init();
+				config.pDataSource = &voice.Buffer;
+				config.pInitialAttachment = group != nullptr ? (ma_node*)&group->Group : nullptr;
+				config.endCallback = Utils::OneShotEndCallback;
+				config.pEndCallbackUserData = &voice;
+
+				res = ma_sound_init_ex(&engineData->Engine, &config, &voice.Sound);
+
+				if (res != MA_SUCCESS)
+				{
+					ma_audio_buffer_ref_uninit(&voice.Buffer);
+				}
+			}
+
+			if (res != MA_SUCCESS)
+			{
+				SetLastError(ErrorCode::OneShotVoiceFailed, engineID, i + 1, voiceCount, path.string());
+				Utils::FreeOneShotPool(m_Data, poolID);
+				return ID::Invalid;
+			}
+
+			voice.Initialized = true;
+			Utils::PushFreeVoice(pool.get(), i);
+		}
+
+		return poolID;
+	}
+
+	bool Context::DestroyOneShotPool(ID poolID)
+	{
+		if (!m_Data->ActiveOneShotPools.Contains(poolID))
+		{
+			SetLastError(ErrorCode::InvalidOneShotPool, poolID);
+			return false;
+		}
+
+		Utils::FreeOneShotPool(m_Data, poolID);
+
+		return true;
+	}
+
+	OneShotPoolStats Context::GetOneShotPoolStats(ID poolID) const
+	{
+		OneShotPool* pool = Utils::GetOneShotPool(poolID);
+		WAVE_ASSERT(pool != nullptr, "Invalid one-shot pool ID: '%zu'", uint64_t(poolID));
+
+		OneShotPoolStats stats;
+
+		if (pool != nullptr)
+		{
+			stats.VoiceCount = pool->VoiceCount;
+			stats.FreeVoices = pool->FreeCount.load(std::memory_order_relaxed);
+			stats.Plays = pool->Plays.load(std::memory_order_relaxed);
+			stats.Rejections = pool->Rejections.load(std::memory_order_relaxed);
+		}
+
+		return stats;
+	}
+
+	bool Context::PlayOneShot(ID engineID, ID poolID, const OneShotParams& params)
+	{
+		OneShotPool* pool = Utils::GetOneShotPool(poolID);
+
+		if (pool == nullptr || pool->EngineID != engineID)
+		{
+			SetLastError(ErrorCode::InvalidOneShotPool, poolID, engineID);
+			return false;
+		}
+
+		uint32_t index = Utils::PopFreeVoice(pool);
+
+		// Busy pools are expected under load, counted rather than reported as an error
+		if (index == UINT32_MAX)
+		{
+			pool->Rejections.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// A voice that played out before is still at its end, ma_sound_start rewinds it
+		ma_sound* sound = &pool->Voices[index].Sound;
+		ma_sound_set_volume(sound, params.Volume);
+		ma_sound_set_pitch(sound, params.Pitch);
+		ma_sound_set_pan(sound, params.Pan);
+		ma_sound_set_spatialization_enabled(sound, (ma_bool32)params.Spacialized);
+		ma_sound_set_position(sound, params.Position.X, params.Position.Y, params.Position.Z);
+
+		if (ma_sound_start(sound) != MA_SUCCESS)
+		{
+			Utils::PushFreeVoice(pool, index);
+			return false;
+		}
+
+		pool->Plays.fetch_add(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	void Context::Update()
+	{
+		WAVE_ASSERT(m_Data != nullptr, "Wave not initialized!%s", "");
+
+		ProcessCommands();
+
+		bool wasExecuting = s_ExecutingCommands;
+		s_ExecutingCommands = true;
+
+		PublishLoadedSounds();
+		Utils::RecycleOneShotVoices(m_Data);
+
+		SoundSpatialStore& store = m_Data->SoundSpatial;
+		uint32_t soundCapacity = m_Data->ActiveSounds.Capacity();
+		uint32_t pageCount = store.GetPageCount();
+
+		for (uint32_t engineIndex = 0; engineIndex < m_Data->ActiveEngines.Capacity(); engineIndex++)
+		{
+			EngineInternalData* engineData = m_Data->ActiveEngines.GetByIndex(engineIndex);
+
+			if (engineData == nullptr)
+			{
+				continue;
+			}
+
+			// Every engine retires the sounds that played out, only engines with virtual voices attenuate
+			const VirtualVoiceSettings& settings = engineData->Data.VirtualVoices;
+			uint32_t maxVoices = engineData->Data.VoiceLimit.MaxVoices;
+			uint32_t activeVoices = settings.Enabled && maxVoices != 0 ? Utils::PruneVoices(m_Data, engineData->Data) : 0;
+			Attenuation::ListenerSet listeners = Utils::GetListenerSet(engineData->Data);
+			uint32_t virtualCount = 0;
+
+			for (uint32_t pageIndex = 0; pageIndex < pageCount; pageIndex++)
+			{
+				SoundSpatialStore::Page* page = store.GetPage(pageIndex);
+				uint32_t firstIndex = pageIndex * SoundSpatialStore::PageSize;
+
+				if (page == nullptr || firstIndex >= soundCapacity)
+				{
+					continue;
+				}
+
+				uint32_t laneCount = std::min(SoundSpatialStore::PageSize, soundCapacity - firstIndex);
+
+				if (!Utils::HasPlayingLanes(*page, laneCount, engineIndex))
+				{
+					continue;
+				}
+
+				if (settings.Enabled)
+				{
+					Attenuation::ComputeGains(*page, laneCount, listeners);
+				}
+
+				for (uint32_t lane = 0; lane < laneCount; lane++)
+				{
+					uint8_t flags = page->Flags[lane];
+
+					if ((flags & SpatialFlag_Active) == 0 || (flags & SpatialFlag_Playing) == 0 || page->EngineIndex[lane] != engineIndex)
+					{
+						continue;
+					}
+
+					SoundInternalData* sound = m_Data->ActiveSounds.GetByIndex(firstIndex + lane);
+
+					if (sound == nullptr)
+					{
+						continue;
+					}
+
+					// Finished on its own since the last update, occlusion batches stop querying it from here on
+					if ((flags & SpatialFlag_Virtual) == 0 && !ma_sound_is_playing(&sound->Sound))
+					{
+						page->Flags[lane] &= ~SpatialFlag_Playing;
+						continue;
+					}
+
+					if (!settings.Enabled)
+					{
+						continue;
+					}
+
+					float gain = page->Gain[lane] * page->Volume[lane] * page->OcclusionGain[lane];
+
+					if (flags & SpatialFlag_Virtual)
+					{
+						bool finished = false;
+						uint64_t cursor = Utils::ProjectVirtualCursor(&sound->Sound, sound->Data, &finished);
+
+						if (finished)
+						{
+							// Ran out while it was virtual, end it the same way a mixed sound would
+							ma_sound_seek_to_pcm_frame(&sound->Sound, cursor);
+							page->Flags[lane] &= ~(SpatialFlag_Playing | SpatialFlag_Virtual);
+						}
+						else if (gain >= settings.RealizeGain && (maxVoices == 0 || activeVoices < maxVoices))
+						{
+							ma_sound_seek_to_pcm_frame(&sound->Sound, cursor);
+							ma_sound_start(&sound->Sound);
+							page->Flags[lane] &= ~SpatialFlag_Virtual;
+							activeVoices++;
+						}
+						else
+						{
+							virtualCount++;
+						}
+					}
+					else if (gain < settings.VirtualizeGain)
+					{
+						Utils::VirtualizeVoice(&sound->Sound, sound->Data);
+						page->Flags[lane] |= SpatialFlag_Virtual;
+						virtualCount++;
+						activeVoices -= activeVoices > 0 ? 1 : 0;
+					}
+				}
+			}
+
+			if (settings.Enabled)
+			{
+				engineData->Data.VirtualVoiceCount = virtualCount;
+			}
+		}
+
+		for (uint32_t engineIndex = 0; engineIndex < m_Data->ActiveEngines.Capacity(); engineIndex++)
+		{
+			EngineInternalData* engineData = m_Data->ActiveEngines.GetByIndex(engineIndex);
+
+			if (engineData == nullptr)
+			{
+				continue;
+			}
+
+			Utils::UpdateOcclusionQueries(m_Data, engineIndex, engineData);
+			Utils::ShrinkSoundPools(m_Data, engineData);
+
+			if (engineData->Events != nullptr)
+			{
+				Command fired;
+
+				while (engineData->Events->GetFired().Pop(fired))
+				{
+					Utils::MirrorFiredEvent(m_Data, engineData, fired);
+				}
+			}
+		}
+
+		// Publish voice counts for the callback stats, which may be read from any thread
+		for (uint32_t engineIndex = 0; engineIndex < m_Data->ActiveEngines.Capacity(); engineIndex++)
+		{
+			EngineInternalData* engineData = m_Data->ActiveEngines.GetByIndex(engineIndex);
+
+			if (engineData != nullptr && engineData->Profiler != nullptr)
+			{
+				engineData->Profiler->SetActiveVoices(Utils::PruneVoices(m_Data, engineData->Data));
+			}
+		}
+
+		s_ExecutingCommands = wasExecuting;
+	}
+
+	uint32_t Context::ProcessCommands()
+	{
+		WAVE_ASSERT(m_Data != nullptr, "Wave not initialized!%s", "");
+
+		bool wasExecuting = s_ExecutingCommands;
+		s_ExecutingCommands = true;
+
+		AllocatedVector<SoundUpdate>& updates = m_Data->CommandUpdates;
+		uint32_t capacity = m_Data->Commands.GetCapacity();
+		uint32_t processed = 0;
+		Command command;
+
+		// Bounded by the capacity so producers that keep pushing can't starve the caller
+		while (processed < capacity && m_Data->Commands.Pop(command))
+		{
+			processed++;
+
+			if (command.Type == CommandType::SoundUpdate)
+			{
+				SoundUpdate& update = updates.emplace_back();
+				update.SoundID = command.Target;
+				update.Position = Vec3(command.Floats[0], command.Floats[1], command.Floats[2]);
+				update.Velocity = Vec3(command.Floats[3], command.Floats[4], command.Floats[5]);
+				update.Direction = Vec3(command.Floats[6], command.Floats[7], command.Floats[8]);
+				update.Volume = command.Floats[9];
+				update.Flags = command.Flags;
+				continue;
+			}
+
+			// Keep the recorded order, pending updates land before the command that followed them
+			if (!updates.empty())
+			{
+				UpdateSounds(updates);
+				updates.clear();
+			}
+
+			ExecuteCommand(command);
+		}
+
+		if (!updates.empty())
+		{
+			UpdateSounds(updates);
+			updates.clear();
+		}
+
+		s_ExecutingCommands = wasExecuting;
+
+		return processed;
+	}
+
+	uint64_t Context::GetDroppedCommandCount() const
+	{
+		WAVE_ASSERT(m_Data != nullptr, "Wave not initialized!%s", "");
+
+		return m_Data->Commands.GetDroppedCount();
+	}
+
+	uint32_t Context::UpdateSounds(std::span<const SoundUpdate> updates)
+	{
+		if (IsDeferringCommands())
+		{
+			uint32_t queued = 0;
+
+			for (const SoundUpdate& update : updates)
+			{
+				const Vec3& p = update.Position;
+				const Vec3& v = update.Velocity;
+				const Vec3& d = update.Direction;
+
+				Command command = MakeCommand(CommandType::SoundUpdate, update.SoundID, { p.X, p.Y, p.Z, v.X, v.Y, v.Z, d.X, d.Y, d.Z, update.Volume });
+				command.Flags = update.Flags;
+
+				// Entries that don't fit are dropped like any other deferred call, the rest still go through
+				if (DeferCommand(command) == DeferResult::Queued)
+				{
+					queued++;
+				}
+			}
+
+			return queued;
+		}
+
+		SoundUpdateBatch& batch = m_Data->UpdateBatch;
+		batch.Clear();
+
+		SoundSpatialStore* store = GetSoundSpatialStore();
+		uint32_t resolved = 0;
+
+		// Resolve every handle once and write the new values straight into the spatial
+		// store, remembering which fields actually changed
+		for (const SoundUpdate& update : updates)
+		{
+			void* sound = nullptr;
+			SoundData* data = nullptr;
+
+			if (!ResolveSound(update.SoundID, &sound, &data))
+			{
+				WAVE_ASSERT(false, "Invalid sound ID: '%zu'", uint64_t(update.SoundID));
+				continue;
+			}
+
+			if (GetSoundSpatialStore(update.SoundID) != store)
+			{
+				WAVE_ASSERT(false, "Sound with ID: '%zu' belongs to another context!", uint64_t(update.SoundID));
+				continue;
+			}
+
+			resolved++;
+
+			uint32_t index = update.SoundID.GetIndex();
+			uint32_t lane = SoundSpatialStore::GetLane(index);
+			SoundSpatialStore::Page& page = store->GetPageFor(index);
+			uint32_t dirty = 0;
+
+			if ((update.Flags & (uint32_t)SoundUpdateFlags::Position) && Utils::StoreLane(page.PositionX, page.PositionY, page.PositionZ, lane, update.Position))
+				dirty |= (uint32_t)SoundUpdateFlags::Position;
+
+			if ((update.Flags & (uint32_t)SoundUpdateFlags::Velocity) && Utils::StoreLane(page.VelocityX, page.VelocityY, page.VelocityZ, lane, update.Velocity))
+				dirty |= (uint32_t)SoundUpdateFlags::Velocity;
+
+			if ((update.Flags & (uint32_t)SoundUpdateFlags::Direction) && Utils::StoreLane(page.DirectionX, page.DirectionY, page.DirectionZ, lane, update.Direction))
+				dirty |= (uint32_t)SoundUpdateFlags::Direction;
+
+			if ((update.Flags & (uint32_t)SoundUpdateFlags::Volume) && page.Volume[lane] != update.Volume)
+			{
+				page.Volume[lane] = update.Volume;
+				dirty |= (uint32_t)SoundUpdateFlags::Volume;
+			}
+
+			// Static emitters never reach miniaudio, sounds still loading pick the values up once ready
+			if (dirty == 0 || sound == nullptr)
+				continue;
+
+			batch.Sounds.push_back((ma_sound*)sound);
+			batch.Indices.push_back(index);
+			batch.DirtyFlags.push_back(dirty);
+		}
+
+		const size_t count = batch.Sounds.size();
+
+		// Push the changed fields to miniaudio one field at a time, reading back from the store
+		for (size_t i = 0; i < count; i++)
+		{
+			if ((batch.DirtyFlags[i] & (uint32_t)SoundUpdateFlags::Position) == 0)
+				continue;
+
+			const SoundSpatialStore::Page& page = store->GetPageFor(batch.Indices[i]);
+			uint32_t lane = SoundSpatialStore::GetLane(batch.Indices[i]);
+			ma_sound_set_position(batch.Sounds[i], page.PositionX[lane], page.PositionY[lane], page.PositionZ[lane]);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if ((batch.DirtyFlags[i] & (uint32_t)SoundUpdateFlags::Velocity) == 0)
+				continue;
+
+			const SoundSpatialStore::Page& page = store->GetPageFor(batch.Indices[i]);
+			uint32_t lane = SoundSpatialStore::GetLane(batch.Indices[i]);
+			ma_sound_set_velocity(batch.Sounds[i], page.VelocityX[lane], page.VelocityY[lane], page.VelocityZ[lane]);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if ((batch.DirtyFlags[i] & (uint32_t)SoundUpdateFlags::Direction) == 0)
+				continue;
+
+			const SoundSpatialStore::Page& page = store->GetPageFor(batch.Indices[i]);
+			uint32_t lane = SoundSpatialStore::GetLane(batch.Indices[i]);
+			ma_sound_set_direction(batch.Sounds[i], page.DirectionX[lane], page.DirectionY[lane], page.DirectionZ[lane]);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if ((batch.DirtyFlags[i] & (uint32_t)SoundUpdateFlags::Volume) == 0)
+				continue;
+
+			ma_sound_set_volume(batch.Sounds[i], store->GetVolume(batch.Indices[i]));
+		}
+
+		return resolved;
+	}
+
+	SoundData* Context::GetSoundInternalData(ID id)
+	{
+		SoundInternalData* data = Utils::GetSound(id);
+
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidSound, id);
+			return nullptr;
+		}
+		
+		return &data->Data;
+	}
+
+	bool Context::ResolveSound(ID id, void** sound, SoundData** data)
+	{
+		SoundInternalData* internalData = Utils::GetSound(id);
+
+		if (internalData == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidSound, id);
+			return false;
+		}
+
+		// Sounds that haven't finished loading have no ma_sound yet
+		*sound = internalData->Data.LoadState == SoundLoadState::Loaded ? (void*)&internalData->Sound : nullptr;
+		*data = &internalData->Data;
+
+		return true;
+	}
+
+	void Context::PublishLoadedSounds()
+	{
+		// Swap the finished loads out so the loader threads are only ever blocked for the swap
+		{
+			std::scoped_lock<std::mutex> lock(m_Data->LoadedSoundsMutex);
+			m_Data->PublishedSounds.swap(m_Data->LoadedSounds);
+		}
+
+		for (SoundLoadResult& result : m_Data->PublishedSounds)
+		{
+			SoundInternalData* data = m_Data->ActiveSounds.Get(result.SoundID);
+			WAVE_ASSERT(data != nullptr, "Loaded sound disappeared: '%zu'", uint64_t(result.SoundID));
+
+			if (data->Data.DestroyPending)
+			{
+				if (result.Success)
+				{
+					ma_sound_uninit(&data->Sound);
+				}
+
+				Utils::FreeSound(m_Data, result.SoundID);
+				continue;
+			}
+
+			if (result.Success)
+			{
+				Utils::ApplyPendingSoundState(m_Data, result.SoundID, data);
+				Utils::AttachSoundToGroup(m_Data, result.SoundID, data);
+
+				// Published last and under the sequencer's lock, so scheduled events never see a half set up sound
+				std::unique_lock<std::mutex> lock = Utils::LockSequencer(m_Data, result.SoundID);
+				data->Data.LoadState = SoundLoadState::Loaded;
+				lock.unlock();
+			}
+			else
+			{
+				data->Data.LoadState = SoundLoadState::Failed;
+				SetLastError(result.Error);
+			}
+
+			if (data->LoadedCallback != nullptr)
+			{
+				data->LoadedCallback(data->LoadedUserData, result.SoundID, result.Success);
+			}
+
+			// The callback may have destroyed the sound
+			data = m_Data->ActiveSounds.Get(result.SoundID);
+
+			if (result.Success && data != nullptr && data->Data.PlayPending)
+			{
+				data->Data.PlayPending = false;
+				Sound(result.SoundID).Play();
+			}
+		}
+
+		m_Data->PublishedSounds.clear();
+	}
+
+	DeferResult Context::DeferCommand(const Command& command)
 	{
-		ma_sound_group Group;
-		SoundGroupData Data;
-	};
+		// Commands are queued on the context owning the target
+		InternalData* contextData = Utils::GetContextData(command.Target);
 
-	struct EngineInternalData
+		if (contextData == nullptr || !contextData->DeferCommands || s_ExecutingCommands)
+		{
+			return DeferResult::Immediate;
+		}
+
+		// Running the call here instead would race the owning thread and land ahead of older queued calls
+		if (!contextData->Commands.Push(command))
+		{
+			WAVE_ASSERT(false, "Command queue is full, increase ContextSettings::CommandQueueCapacity!%s", "");
+			SetLastError(ErrorCode::CommandQueueFull, command.Target);
+			return DeferResult::Rejected;
+		}
+
+		return DeferResult::Queued;
+	}
+
+	bool Context::IsDeferringCommands() const
 	{
-		ma_engine Engine;
-		EngineData Data;
-	};
+		WAVE_ASSERT(m_Data != nullptr, "Wave not initialized!%s", "");
 
-	struct ContextPair
+		return m_Data->DeferCommands && !s_ExecutingCommands;
+	}
+
+	bool Context::IsDeferringCommands(ID id)
 	{
-		Context* pCtx;
-		ContextInternalData Data;
-	};
+		InternalData* contextData = Utils::GetContextData(id);
+
+		return contextData != nullptr && contextData->DeferCommands && !s_ExecutingCommands;
+	}
 
-	struct SoundPair
+	void Context::ExecuteCommand(const Command& command)
 	{
-		Sound* pSound;
-		SoundInternalData Data;
-	};
+		const float* f = command.Floats;
+		const uint64_t* i = command.Integers;
+
+		switch (command.Type)
+		{
+			case CommandType::SoundGroupPlay:
+			case CommandType::SoundGroupRestart:
+			case CommandType::SoundGroupPause:
+			case CommandType::SoundGroupStop:
+			case CommandType::SoundGroupSetVolume:
+			case CommandType::SoundGroupSetPitch:
+			case CommandType::SoundGroupSetPan:
+			case CommandType::SoundGroupSetPosition:
+			case CommandType::SoundGroupSetDirection:
+			case CommandType::SoundGroupSetVelocity:
+			case CommandType::SoundGroupSetMinDistance:
+			case CommandType::SoundGroupSetMaxDistance:
+			case CommandType::SoundGroupSetAttenuationModel:
+			case CommandType::SoundGroupSetSpacialized:
+			case CommandType::SoundGroupDestroy:
+				// The target may have been destroyed by an earlier command
+				if (!m_Data->ActiveSoundGroups.Contains(command.Target))
+					return;
+				break;
+			case CommandType::EngineStart:
+			case CommandType::EngineStop:
+			case CommandType::EngineSetVirtualVoiceSettings:
+			case CommandType::EngineSetVoiceLimitSettings:
+			case CommandType::EngineUpdateListener:
+			case CommandType::EngineSetListenerWorldUp:
+			case CommandType::EngineSetListenerCone:
+			case CommandType::EngineSetListenerEnabled:
+			case CommandType::EngineSetOcclusionSettings:
+				if (!m_Data->ActiveEngines.Contains(command.Target))
+					return;
+				break;
+			default:
+				if (!m_Data->ActiveSounds.Contains(command.Target))
+					return;
+				break;
+		}
+
+		Sound sound(command.Target);
 
-	struct SoundGroupPair
+		switch (command.Type)
+		{
+			case CommandType::SoundPlay:                              sound.Play(); break;
+			case CommandType::SoundRestart:                           sound.Restart(); break;
+			case CommandType::SoundPause:                             sound.Pause(); break;
+			case CommandType::SoundStop:                              sound.Stop(); break;
+			case CommandType::SoundSeek:                              sound.SeekToPCMFrame(i[0]); break;
+			case CommandType::SoundSetVolume:                         sound.SetVolume(f[0]); break;
+			case CommandType::SoundSetPitch:                          sound.SetPitch(f[0]); break;
+			case CommandType::SoundSetDopplerFactor:                  sound.SetDopplerFactor(f[0]); break;
+			case CommandType::SoundSetPosition:                       sound.SetPosition(Vec3(f[0], f[1], f[2])); break;
+			case CommandType::SoundSetDirection:                      sound.SetDirection(Vec3(f[0], f[1], f[2])); break;
+			case CommandType::SoundSetVelocity:                       sound.SetVelocity(Vec3(f[0], f[1], f[2])); break;
+			case CommandType::SoundSetAudioCone:                      sound.SetAudioCone({ f[0], f[1], f[2] }); break;
+			case CommandType::SoundSetMinGain:                        sound.SetMinGain(f[0]); break;
+			case CommandType::SoundSetMaxGain:                        sound.SetMaxGain(f[0]); break;
+			case CommandType::SoundSetFalloff:                        sound.SetFalloff(f[0]); break;
+			case CommandType::SoundSetMinDistance:                    sound.SetMinDistance(f[0]); break;
+			case CommandType::SoundSetMaxDistance:                    sound.SetMaxDistance(f[0]); break;
+			case CommandType::SoundSetAttenuationModel:               sound.SetAttenuationModel((AttenuationModel)i[0]); break;
+			case CommandType::SoundSetDirectionalAttenuationFactor:   sound.SetDirectionalAttenuationFactor(f[0]); break;
+			case CommandType::SoundSetPan:                            sound.SetPan(f[0]); break;
+			case CommandType::SoundSetPanMode:                        sound.SetPanMode((PanMode)i[0]); break;
+			case CommandType::SoundSetPositioning:                    sound.SetPositioning((Positioning)i[0]); break;
+			case CommandType::SoundSetPinnedListenerIndex:            sound.SetPinnedListenerIndex((uint32_t)i[0]); break;
+			case CommandType::SoundSetStartTimeInPCMFrames:           sound.SetStartTimeInPCMFrames(i[0]); break;
+			case CommandType::SoundSetStopTimeInPCMFrames:            sound.SetStopTimeInPCMFrames(i[0]); break;
+			case CommandType::SoundSetStopTimeWithFadeInPCMFrames:    sound.SetStopTimeWithFadeInPCMFrames(i[0], i[1]); break;
+			case CommandType::SoundSetFadeInPCMFrames:                sound.SetFadeInPCMFrames(f[0], f[1], i[0]); break;
+			case CommandType::SoundSetFadeStartInPCMFrames:           sound.SetFadeStartInPCMFrames(f[0], f[1], i[0], i[1]); break;
+			case CommandType::SoundSetStartTimeInMilliseconds:        sound.SetStartTimeInMilliseconds(i[0]); break;
+			case CommandType::SoundSetStopTimeInMilliseconds:         sound.SetStopTimeInMilliseconds(i[0]); break;
+			case CommandType::SoundSetStopTimeWithFadeInMilliseconds: sound.SetStopTimeWithFadeInMilliseconds(i[0], i[1]); break;
+			case CommandType::SoundSetFadeInMilliseconds:             sound.SetFadeInMilliseconds(f[0], f[1], i[0]); break;
+			case CommandType::SoundSetFadeStartInMilliseconds:        sound.SetFadeStartInMilliseconds(f[0], f[1], i[0], i[1]); break;
+			case CommandType::SoundSetLooping:                        sound.SetLooping(i[0] != 0); break;
+			case CommandType::SoundSetSpacialized:                    sound.SetSpacialized(i[0] != 0); break;
+			case CommandType::SoundSetPriority:                       sound.SetPriority((uint8_t)i[0]); break;
+			case CommandType::SoundSetOcclusion:                      sound.SetOcclusion(f[0]); break;
+			case CommandType::SoundDestroy:                           DestroySound(command.Target); break;
+
+			case CommandType::SoundGroupPlay:                         SoundGroup(command.Target).Play(); break;
+			case CommandType::SoundGroupRestart:                      SoundGroup(command.Target).Restart(); break;
+			case CommandType::SoundGroupPause:                        SoundGroup(command.Target).Pause(); break;
+			case CommandType::SoundGroupStop:                         SoundGroup(command.Target).Stop(); break;
+			case CommandType::SoundGroupSetVolume:                    SoundGroup(command.Target).SetVolume(f[0]); break;
+			case CommandType::SoundGroupSetPitch:                     SoundGroup(command.Target).SetPitch(f[0]); break;
+			case CommandType::SoundGroupSetPan:                       SoundGroup(command.Target).SetPan(f[0]); break;
+			case CommandType::SoundGroupSetPosition:                  SoundGroup(command.Target).SetPosition(Vec3(f[0], f[1], f[2])); break;
+			case CommandType::SoundGroupSetDirection:                 SoundGroup(command.Target).SetDirection(Vec3(f[0], f[1], f[2])); break;
+			case CommandType::SoundGroupSetVelocity:                  SoundGroup(command.Target).SetVelocity(Vec3(f[0], f[1], f[2])); break;
+			case CommandType::SoundGroupSetMinDistance:               SoundGroup(command.Target).SetMinDistance(f[0]); break;
+			case CommandType::SoundGroupSetMaxDistance:               SoundGroup(command.Target).SetMaxDistance(f[0]); break;
+			case CommandType::SoundGroupSetAttenuationModel:          SoundGroup(command.Target).SetAttenuationModel((AttenuationModel)i[0]); break;
+			case CommandType::SoundGroupSetSpacialized:               SoundGroup(command.Target).SetSpacialized(i[0] != 0); break;
+			case CommandType::SoundGroupDestroy:                      DestroySoundGroup(command.Target); break;
+
+			case CommandType::EngineStart:                            Engine(command.Target).Start(); break;
+			case CommandType::EngineStop:                             Engine(command.Target).Stop(); break;
+			case CommandType::EngineSetVirtualVoiceSettings:
+			{
+				VirtualVoiceSettings settings;
+				settings.Enabled = i[0] != 0;
+				settings.VirtualizeGain = f[0];
+				settings.RealizeGain = f[1];
+				Engine(command.Target).SetVirtualVoiceSettings(settings);
+				break;
+			}
+			case CommandType::EngineSetVoiceLimitSettings:
+			{
+				VoiceLimitSettings settings;
+				settings.MaxVoices = (uint32_t)i[0];
+				settings.StealFadeInMilliseconds = (uint32_t)i[1];
+				Engine(command.Target).SetVoiceLimitSettings(settings);
+				break;
+			}
+			case CommandType::EngineUpdateListener:
+			{
+				ListenerUpdate update;
+				update.ListenerIndex = (uint32_t)i[0];
+				update.Position = Vec3(f[0], f[1], f[2]);
+				update.Direction = Vec3(f[3], f[4], f[5]);
+				update.Velocity = Vec3(f[6], f[7], f[8]);
+				update.Flags = command.Flags;
+				Engine(command.Target).UpdateListeners({ &update, 1 });
+				break;
+			}
+			case CommandType::EngineSetListenerWorldUp:               Engine(command.Target).SetListenerWorldUp((uint32_t)i[0], Vec3(f[0], f[1], f[2])); break;
+			case CommandType::EngineSetListenerCone:                  Engine(command.Target).SetListenerCone((uint32_t)i[0], { f[0], f[1], f[2] }); break;
+			case CommandType::EngineSetListenerEnabled:               Engine(command.Target).SetListenerEnabled((uint32_t)i[0], i[1] != 0); break;
+			case CommandType::EngineSetOcclusionSettings:
+			{
+				OcclusionSettings settings;
+				settings.QueryCallback = (OcclusionQueryCallback)i[0];
+				settings.pUserData = (void*)i[1];
+				settings.MaxQueriesPerBatch = command.Flags;
+				settings.BatchIntervalInMilliseconds = (uint32_t)f[0];
+				settings.MinCutoffFrequency = f[1];
+				settings.MaxCutoffFrequency = f[2];
+				settings.OccludedGain = f[3];
+				Engine(command.Target).SetOcclusionSettings(settings);
+				break;
+			}
+
+			case CommandType::None:
+			case CommandType::SoundUpdate:
+				break;
+		}
+	}
+
+	SoundSpatialStore* Context::GetSoundSpatialStore(ID soundID)
 	{
-		SoundGroup* pSoundGroup;
-		SoundGroupInternalData Data;
-	};
+		InternalData* contextData = Utils::GetContextData(soundID);
+		WAVE_ASSERT(contextData != nullptr, "No context owns ID: '%zu'", uint64_t(soundID));
+
+		return &contextData->SoundSpatial;
+	}
 
-	struct EnginePair
+	SoundSpatialStore* Context::GetSoundSpatialStore() const
 	{
-		Engine* pEngine;
-		EngineInternalData Data;
-	};
+		WAVE_ASSERT(m_Data != nullptr, "Wave not initialized!%s", "");
 
-	struct InternalData
+		return &m_Data->SoundSpatial;
+	}
+
+	uint64_t Context::GetVirtualCursor(ID soundID)
 	{
-		std::unordered_map<ID, SoundPair> ActiveSounds;
-		std::unordered_map<ID, SoundGroupPair> ActiveSoundGroups;
-		std::unordered_map<ID, EnginePair> ActiveEngines;
+		SoundInternalData* data = Utils::GetSound(soundID);
+		WAVE_ASSERT(data != nullptr, "Invalid sound ID: '%zu'", uint64_t(soundID));
 
-		ContextPair CurrentContext;
-	};
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidSound, soundID);
+			return 0;
+		}
 
-	static InternalData* s_Data = nullptr;
+		bool finished = false;
+		return Utils::ProjectVirtualCursor(&data->Sound, data->Data, &finished);
+	}
 
-	ContextResult Context::Init(const ContextSettings& settings)
+	void Context::SetVirtualCursor(ID soundID, uint64_t cursor)
 	{
-		ContextResult result;
-		result.Success = false;
+		SoundInternalData* data = Utils::GetSound(soundID);
+		WAVE_ASSERT(data != nullptr, "Invalid sound ID: '%zu'", uint64_t(soundID));
 
-		WAVE_ASSERT(s_Data == nullptr, "Trying to initialize Wave multiple times!%s", "");
-		s_Data = new InternalData();
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidSound, soundID);
+			return;
+		}
 
-		s_Data->CurrentContext.pCtx = this;
+		data->Data.VirtualCursorInPCMFrames = cursor;
+		data->Data.VirtualStartTimeInPCMFrames = ma_engine_get_time_in_pcm_frames(ma_sound_get_engine(&data->Sound));
+	}
 
-		// Initialize Miniaudio
-		ma_context_config config = ma_context_config_init();
-		config.pUserData = settings.pUserData;
+	bool Context::DevirtualizeSound(ID soundID, bool resume)
+	{
+		SoundInternalData* data = Utils::GetSound(soundID);
+		WAVE_ASSERT(data != nullptr, "Invalid sound ID: '%zu'", uint64_t(soundID));
 
-		ma_result res = ma_context_init(nullptr, 0, &config, &s_Data->CurrentContext.Data.Context);
-		
-		if (res != MA_SUCCESS)
+		if (data == nullptr)
 		{
-			m_LastErrorMsg = "Failed to initialize miniaudio!";
-			return result;
+			SetLastError(ErrorCode::InvalidSound, soundID);
+			return false;
 		}
 
-		res = ma_context_get_devices(
-			&s_Data->CurrentContext.Data.Context,
-			&s_Data->CurrentContext.Data.PlaybackDeviceInfos,
-			&s_Data->CurrentContext.Data.PlaybackDeviceCount,
-			&s_Data->CurrentContext.Data.CaptureDeviceInfos,
-			&s_Data->CurrentContext.Data.CaptureDeviceCount
-		);
-		
-		if (res != MA_SUCCESS)
+		bool finished = false;
+		uint64_t cursor = Utils::ProjectVirtualCursor(&data->Sound, data->Data, &finished);
+
+		ma_sound_seek_to_pcm_frame(&data->Sound, cursor);
+		SoundSpatialStore& store = Utils::GetContextData(soundID)->SoundSpatial;
+		store.SetFlag(soundID.GetIndex(), SpatialFlag_Virtual, false);
+
+		if (finished)
 		{
-			m_LastErrorMsg = "Failed to enumerate hardware devices!";
-			return result;
+			store.SetFlag(soundID.GetIndex(), SpatialFlag_Playing, false);
+			return false;
 		}
 
-		if (settings.EnableDebugLogging)
+		if (resume)
 		{
-			ma_log* log = ma_context_get_log(&s_Data->CurrentContext.Data.Context);
-			
-			ma_log_callback callback;
-			callback.onLog = settings.LogCallback;
+			ma_sound_start(&data->Sound);
+		}
 
-			res = ma_log_register_callback(log, callback);
-			
-			if (res != MA_SUCCESS)
-			{
-				m_LastErrorMsg = "Failed to register log callback";
-				return result;
-			}
+		return true;
+	}
+
+	bool Context::AcquireVoice(ID soundID)
+	{
+		SoundInternalData* data = Utils::GetSound(soundID);
+		WAVE_ASSERT(data != nullptr, "Invalid sound ID: '%zu'", uint64_t(soundID));
+
+		if (data == nullptr)
+		{
+			return false;
 		}
 
-		if (settings.EnumerateDevices)
+		InternalData* contextData = Utils::GetContextData(soundID);
+		SoundSpatialStore& store = contextData->SoundSpatial;
+		EngineInternalData* engineData = contextData->ActiveEngines.GetByIndex(store.GetEngineIndex(soundID.GetIndex()));
+		WAVE_ASSERT(engineData != nullptr, "Sound with ID: '%zu' outlived its engine!", uint64_t(soundID));
+
+		if (engineData == nullptr)
 		{
-			DeviceInfo deviceInfo = {};
+			return false;
+		}
+
+		EngineData& engine = engineData->Data;
+		uint32_t maxVoices = engine.VoiceLimit.MaxVoices;
+
+		// A paused sound may still be in the list, drop it so it isn't tracked twice
+		if (data->Data.IsVoiceTracked)
+		{
+			Utils::PruneVoices(contextData, engine);
+		}
+
+		// Voices only over-counts the mixed voices, so there's no need to prune until it's full
+		if (maxVoices == 0 || engine.Voices.size() < maxVoices || Utils::PruneVoices(contextData, engine) < maxVoices)
+		{
+			engine.Voices.push_back(soundID);
+			data->Data.IsVoiceTracked = true;
+			return true;
+		}
+
+		Attenuation::ListenerSet listeners = Utils::GetListenerSet(engine);
+
+		// Lowest priority first, then whichever is quietest at the listener right now
+		size_t victim = engine.Voices.size();
+		uint8_t victimPriority = 0;
+		float victimGain = 0.0f;
+
+		for (size_t i = 0; i < engine.Voices.size(); i++)
+		{
+			uint32_t index = engine.Voices[i].GetIndex();
 
-			for (uint32_t i = 0; i < s_Data->CurrentContext.Data.PlaybackDeviceCount; i++)
+			if (store.HasFlag(index, SpatialFlag_Virtual))
 			{
-				deviceInfo.Name = std::string(s_Data->CurrentContext.Data.PlaybackDeviceInfos[i].name);
-				deviceInfo.Type = DeviceType::Playback;
-				deviceInfo.IsDefault = (bool)s_Data->CurrentContext.Data.PlaybackDeviceInfos[i].isDefault;
-				result.PlaybackDeviceInfos.push_back(deviceInfo);
+				continue;
 			}
 
-			for (uint32_t i = 0; i < s_Data->CurrentContext.Data.CaptureDeviceCount; i++)
+			uint8_t priority = contextData->ActiveSounds.Get(engine.Voices[i])->Data.Priority;
+			const SoundSpatialStore::Page& page = store.GetPageFor(index);
+			uint32_t lane = SoundSpatialStore::GetLane(index);
+			float gain = Attenuation::ComputeGain(page, lane, listeners) * page.Volume[lane] * page.OcclusionGain[lane];
+
+			if (victim == engine.Voices.size() || priority < victimPriority || (priority == victimPriority && gain < victimGain))
 			{
-				deviceInfo.Name = std::string(s_Data->CurrentContext.Data.CaptureDeviceInfos[i].name);
-				deviceInfo.Type = DeviceType::Capture;
-				deviceInfo.IsDefault = (bool)s_Data->CurrentContext.Data.CaptureDeviceInfos[i].isDefault;
-				result.CaptureDeviceInfos.push_back(deviceInfo);
+				victim = i;
+				victimPriority = priority;
+				victimGain = gain;
 			}
 		}
 
-		result.Success = true;
-		return result;
-	}
+		if (victim == engine.Voices.size() || victimPriority > data->Data.Priority)
+		{
+			engine.VoiceRejections++;
+			return false;
+		}
 
-	bool Context::Shutdown()
-	{
-		WAVE_ASSERT(s_Data != nullptr, "Trying to shutdown Wave without initializing!%s", "");
+		ID victimID = engine.Voices[victim];
+		SoundInternalData* victimData = contextData->ActiveSounds.Get(victimID);
 
-		// Shutdown Miniaudio
-		ma_context* context = &s_Data->CurrentContext.Data.Context;
-		ma_result res = ma_context_uninit(context);
-		
-		if (res != MA_SUCCESS)
+		uint64_t fadeLength = (uint64_t)engine.VoiceLimit.StealFadeInMilliseconds * ma_engine_get_sample_rate(&engineData->Engine) / 1000;
+
+		if (fadeLength == 0)
 		{
-			m_LastErrorMsg = "Failed to shutdown miniaudio!";
-			return false;
+			ma_sound_stop(&victimData->Sound);
+		}
+		else
+		{
+			uint64_t now = ma_engine_get_time_in_pcm_frames(&engineData->Engine);
+			ma_sound_set_stop_time_with_fade_in_pcm_frames(&victimData->Sound, now + fadeLength, fadeLength);
 		}
 
-		delete s_Data;
-		s_Data = nullptr;
+		victimData->Data.WasStolen = true;
+		victimData->Data.IsVoiceTracked = false;
+		victimData->Data.IsPaused = false;
+		store.SetFlag(victimID.GetIndex(), SpatialFlag_Playing, false);
+
+		engine.Voices[victim] = soundID;
+		data->Data.IsVoiceTracked = true;
+		engine.VoiceSteals++;
 
 		return true;
 	}
 
-	Sound Context::CreateSoundFromFile(ID engineID, const std::filesystem::path& path)
+	uint32_t Context::CountActiveVoices(ID engineID)
 	{
-		ID soundID = ID(s_Data->ActiveSounds.size());
-		Sound sound = Sound(soundID);
-		
-		WAVE_ASSERT(!s_Data->ActiveSounds.contains(soundID), "Sound with ID: '%zu' already exists!", uint64_t(soundID));
-		SoundPair& pair = s_Data->ActiveSounds[soundID];
-		pair.pSound = &sound;
-		
-		ma_sound_config config = ma_sound_config_init();
-		std::string filepath = path.string();
-		config.pFilePath = filepath.c_str();
+		EngineInternalData* engineData = Utils::GetEngine(engineID);
+		WAVE_ASSERT(engineData != nullptr, "Invalid engine ID: '%zu'", uint64_t(engineID));
 
-		WAVE_ASSERT(s_Data->ActiveEngines.contains(engineID), "Invalid Engine ID: '%zu'", uint64_t(engineID));
-		ma_engine* engine = &s_Data->ActiveEngines[engineID].Data.Engine;
-		ma_result res = ma_sound_init_ex(engine, &config, &pair.Data.Sound);
-		
-		if (res != MA_SUCCESS)
+		return engineData != nullptr ? Utils::PruneVoices(Utils::GetContextData(engineID), engineData->Data) : 0;
+	}
+
+	bool Context::SetSoundOcclusion(ID id, float occlusion)
+	{
+		SoundInternalData* data = Utils::GetSound(id);
+		WAVE_ASSERT(data != nullptr, "Invalid Sound ID: '%zu'", uint64_t(id));
+
+		if (data == nullptr)
 		{
-			m_LastErrorMsg = std::format("Failed to create sound from: '{}'", filepath);
-			return Sound(ID::Invalid);
+			SetLastError(ErrorCode::InvalidSound, id);
+			return false;
 		}
 
-		res = ma_sound_get_length_in_seconds(&pair.Data.Sound, &pair.Data.Data.LengthInSeconds);
+		occlusion = std::clamp(occlusion, 0.0f, 1.0f);
 
-		if (res != MA_SUCCESS)
+		// Query results mostly repeat from one batch to the next, don't recompute the filter for those
+		if (occlusion == data->Data.Occlusion)
 		{
-			m_LastErrorMsg = std::format("Failed to get length of sound in seconds with ID: '{}'", uint64_t(soundID));
-			return Sound(ID::Invalid);
+			return true;
 		}
 
-		res = ma_sound_get_length_in_pcm_frames(&pair.Data.Sound, &pair.Data.Data.LengthInPCMFrames);
+		data->Data.Occlusion = occlusion;
 
-		if (res != MA_SUCCESS)
+		// Loading sounds get it in ApplyPendingSoundState
+		if (data->Data.LoadState != SoundLoadState::Loaded)
 		{
-			m_LastErrorMsg = std::format("Failed to get length of sound in pcm frames with ID: '{}'", uint64_t(soundID));
-			return Sound(ID::Invalid);
+			return true;
 		}
 
-		return sound;
+		return Utils::ApplyOcclusion(Utils::GetContextData(id), id, data);
 	}
 
-	Sound Context::CreateSoundFromDataSource(ID engineID, const uint8_t* src, size_t size)
+	SoundGroupData* Context::GetSoundGroupInternalData(ID id)
 	{
-		WAVE_ASSERT(false, "Not implemented yet!%s", "");
-		return Sound(ID::Invalid);
+		SoundGroupInternalData* data = Utils::GetSoundGroup(id);
+
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidSoundGroup, id);
+			return nullptr;
+		}
+
+		return &data->Data;
 	}
 
-	bool Context::DestroySound(ID id)
+	bool Context::ResolveSoundGroup(ID id, void** group, SoundGroupData** data)
 	{
-		ma_sound* sound = (ma_sound*)GetSoundInternal(id);
-		
-		if (sound == nullptr)
+		SoundGroupInternalData* internalData = Utils::GetSoundGroup(id);
+
+		if (internalData == nullptr)
 		{
-			m_LastErrorMsg = std::format("Failed to destroy sound with ID: '{}'", uint64_t(id));
+			SetLastError(ErrorCode::InvalidSoundGroup, id);
 			return false;
 		}
-		
-		ma_sound_uninit(sound);
 
-		s_Data->ActiveSounds.erase(id);
+		*group = (void*)&internalData->Group;
+		*data = &internalData->Data;
 
 		return true;
 	}
 
-    SoundGroup Context::CreateSoundGroup(ID engineID, ID parentGroupID)
-    {
-		ID soundGroupID = ID(s_Data->ActiveSoundGroups.size());
-		SoundGroup soundGroup(soundGroupID, parentGroupID);
-
-		WAVE_ASSERT(!s_Data->ActiveSoundGroups.contains(soundGroupID), "Sound Group with ID: '%zu' already exists!", uint64_t(soundGroupID));
-		SoundGroupPair& pair = s_Data->ActiveSoundGroups[soundGroupID];
-		pair.pSoundGroup = &soundGroup;
-
-		ma_sound_group_config config = ma_sound_group_config_init();
+	void Context::PruneSoundGroup(ID id)
+	{
+		SoundGroupInternalData* data = Utils::GetSoundGroup(id);
+		WAVE_ASSERT(data != nullptr, "Invalid Sound Group ID: '%zu'", uint64_t(id));
 
-		WAVE_ASSERT(s_Data->ActiveEngines.contains(engineID), "Invalid Engine ID: '%zu'", uint64_t(engineID));
-		ma_engine* engine = &s_Data->ActiveEngines[engineID].Data.Engine;
+		if (data != nullptr)
+		{
+			Utils::PruneGroupMembers(Utils::GetContextData(id), id, data->Data);
+		}
+	}
 
-		ma_sound_group* parentGroup = nullptr;
+	bool Context::AddSoundGroupEffect(ID id, const BusEffect& effect)
+	{
+		SoundGroupInternalData* data = Utils::GetSoundGroup(id);
+		WAVE_ASSERT(data != nullptr, "Invalid Sound Group ID: '%zu'", uint64_t(id));
 
-		if (parentGroupID != ID::Invalid)
+		if (data == nullptr)
 		{
-			WAVE_ASSERT(s_Data->ActiveSoundGroups.contains(parentGroupID), "Invalid Sound Group ID: '%zu'", uint64_t(parentGroupID));
-			parentGroup = &s_Data->ActiveSoundGroups[parentGroupID].Data.Group;
+			return false;
 		}
 
-		ma_result res = ma_sound_group_init(engine, 0, parentGroup, &pair.Data.Group);
+		ma_engine* engine = ma_sound_get_engine(&data->Group);
+		ma_uint32 channels = ma_node_get_output_channels(&data->Group, 0);
 
-		if (res != MA_SUCCESS)
+		InternalData* contextData = Utils::GetContextData(id);
+		AllocatedPtr<BusEffectNode> effectNode = MakeAllocated<BusEffectNode>(contextData->Memory);
+
+		if (effectNode == nullptr)
 		{
-			m_LastErrorMsg = "Failed to create sound group";
-			return SoundGroup(ID::Invalid);
+			SetLastError(ErrorCode::OutOfMemory, id, 0, 0, "adding a sound group effect");
+			return false;
 		}
 
-        return soundGroup;
-    }
-
-    bool Context::DestroySoundGroup(ID id)
-    {
-		ma_sound_group* soundGroup = (ma_sound_group*)GetSoundGroupInternal(id);
+		effectNode->Settings = effect;
 
-		if (soundGroup == nullptr)
+		if (Utils::InitBusEffect(engine, channels, &contextData->MiniaudioCallbacks, effectNode.get()) != MA_SUCCESS)
 		{
-			m_LastErrorMsg = std::format("Failed to destroy sound group with ID: '{}'", uint64_t(id));
+			SetLastError(ErrorCode::EffectInitFailed, id);
 			return false;
 		}
 
-		ma_sound_group_uninit(soundGroup);
+		// Wire the output first, so the effect is already connected when the chain is switched over to it
+		ma_node_attach_output_bus(effectNode->GetNode(), 0, Utils::GetGroupOutput(Utils::GetContextData(id), data), 0);
+		ma_node_attach_output_bus(Utils::GetGroupTail(data), 0, effectNode->GetNode(), 0);
 
-		s_Data->ActiveSoundGroups.erase(id);
+		data->Effects.push_back(std::move(effectNode));
+		data->Data.EffectCount = (uint32_t)data->Effects.size();
 
 		return true;
-    }
+	}
 
-	Engine Context::CreateEngine()
+	bool Context::UpdateSoundGroupEffect(ID id, uint32_t index, const BusEffect& effect)
 	{
-		ID engineID = ID(s_Data->ActiveEngines.size());
-		Engine engine = Engine(engineID);
+		SoundGroupInternalData* data = Utils::GetSoundGroup(id);
+		WAVE_ASSERT(data != nullptr, "Invalid Sound Group ID: '%zu'", uint64_t(id));
 
-		WAVE_ASSERT(!s_Data->ActiveEngines.contains(engineID), "Engine with ID: '%zu' already exists!", uint64_t(engineID));
-		EnginePair& pair = s_Data->ActiveEngines[engineID];
-		pair.pEngine = &engine;
+		if (data == nullptr)
+		{
+			return false;
+		}
 
-		ma_engine_config config = ma_engine_config_init();
-		config.noAutoStart = true;
-		
-		ma_result res = ma_engine_init(&config, &pair.Data.Engine);
-		
-		if (res != MA_SUCCESS)
+		if (index >= data->Effects.size() || data->Effects[index]->Settings.Type != effect.Type)
 		{
-			m_LastErrorMsg = "Failed to create engine";
-			return Engine(ID::Invalid);
+			SetLastError(ErrorCode::EffectNotFound, id, index);
+			return false;
 		}
 
-		return engine;
-	}
+		BusEffectNode* effectNode = data->Effects[index].get();
+		ma_uint32 channels = ma_node_get_output_channels(effectNode->GetNode(), 0);
+		ma_uint32 sampleRate = ma_engine_get_sample_rate(ma_sound_get_engine(&data->Group));
+		ma_result res = MA_SUCCESS;
 
-	bool Context::DestroyEngine(ID id)
-	{
-		ma_engine* engine = (ma_engine*)GetEngineInternal(id);
-		
-		if (engine == nullptr)
+		// Filters keep their state across a reinit, so sweeping the cutoff doesn't click
+		switch (effect.Type)
+		{
+			case BusEffectType::LowPass:
+			{
+				ma_lpf_config config = ma_lpf_config_init(ma_format_f32, channels, sampleRate, effect.CutoffFrequency, effect.Order);
+				res = ma_lpf_node_reinit(&config, &effectNode->LowPass);
+				break;
+			}
+			case BusEffectType::HighPass:
+			{
+				ma_hpf_config config = ma_hpf_config_init(ma_format_f32, channels, sampleRate, effect.CutoffFrequency, effect.Order);
+				res = ma_hpf_node_reinit(&config, &effectNode->HighPass);
+				break;
+			}
+			case BusEffectType::BandPass:
+			{
+				ma_bpf_config config = ma_bpf_config_init(ma_format_f32, channels, sampleRate, effect.CutoffFrequency, effect.Order);
+				res = ma_bpf_node_reinit(&config, &effectNode->BandPass);
+				break;
+			}
+			case BusEffectType::Delay:
+				ma_delay_node_set_decay(&effectNode->Delay, effect.Decay);
+				ma_delay_node_set_wet(&effectNode->Delay, effect.Wet);
+				ma_delay_node_set_dry(&effectNode->Delay, effect.Dry);
+				break;
+			case BusEffectType::Custom:
+				// The audio thread may be inside the callback, its user data can carry parameters instead
+				res = MA_INVALID_OPERATION;
+				break;
+		}
+
+		if (res != MA_SUCCESS)
 		{
-			m_LastErrorMsg = std::format("Failed to destroy engine with ID: '{}'", uint64_t(id));
+			SetLastError(ErrorCode::EffectUpdateFailed, id, index);
 			return false;
 		}
-		
-		ma_engine_uninit(engine);
 
-		s_Data->ActiveEngines.erase(id);
+		BusEffect& settings = effectNode->Settings;
+		settings.CutoffFrequency = effect.CutoffFrequency;
+		settings.Order = effect.Order;
+		settings.Decay = effect.Decay;
+		settings.Wet = effect.Wet;
+		settings.Dry = effect.Dry;
 
 		return true;
 	}
 
-	void Context::SetErrorMsg(const std::string& msg)
+	void Context::ClearSoundGroupEffects(ID id)
 	{
-		WAVE_ASSERT(s_Data != nullptr && s_Data->CurrentContext.pCtx != nullptr, "Wave not initialized... No active context%s", "");
-		
-		s_Data->CurrentContext.pCtx->m_LastErrorMsg = msg;
+		SoundGroupInternalData* data = Utils::GetSoundGroup(id);
+		WAVE_ASSERT(data != nullptr, "Invalid Sound Group ID: '%zu'", uint64_t(id));
+
+		if (data == nullptr || data->Effects.empty())
+		{
+			return;
+		}
+
+		InternalData* contextData = Utils::GetContextData(id);
+
+		// Bypass the chain before tearing it down, uninit detaches each effect on its own
+		ma_node_attach_output_bus(&data->Group, 0, Utils::GetGroupOutput(contextData, data), 0);
+
+		for (AllocatedPtr<BusEffectNode>& effect : data->Effects)
+		{
+			Utils::UninitBusEffect(effect.get(), &contextData->MiniaudioCallbacks);
+		}
+
+		data->Effects.clear();
+		data->Data.EffectCount = 0;
 	}
 
-	void* Context::GetSoundInternal(ID id)
+	void* Context::GetEngineInternal(ID id)
 	{
-		WAVE_ASSERT(s_Data != nullptr, "Wave not initialized!%s", "");
-		WAVE_ASSERT(s_Data->ActiveSounds.contains(id), "Invalid sound ID: '%zu'", uint64_t(id));
-		
-		SoundPair& pair = s_Data->ActiveSounds[id];
+		EngineInternalData* data = Utils::GetEngine(id);
+		WAVE_ASSERT(data != nullptr, "Invalid engine ID: '%zu'", uint64_t(id));
 		
-		return (void*)&pair.Data.Sound;
+		return data != nullptr ? (void*)&data->Engine : nullptr;
 	}
 
-	SoundData* Context::GetSoundInternalData(ID id)
+	CallbackProfiler* Context::GetEngineProfiler(ID id)
 	{
-		WAVE_ASSERT(s_Data != nullptr, "Wave not initialized!%s", "");
-		WAVE_ASSERT(s_Data->ActiveSounds.contains(id), "Invalid sound ID: '%zu'", uint64_t(id));
-		
-		SoundPair& pair = s_Data->ActiveSounds[id];
-		
-		return &pair.Data.Data;
+		EngineInternalData* data = Utils::GetEngine(id);
+		WAVE_ASSERT(data != nullptr, "Invalid engine ID: '%zu'", uint64_t(id));
+
+		return data != nullptr ? data->Profiler.get() : nullptr;
 	}
 
-	void* Context::GetSoundGroupInternal(ID id)
+	void* Context::GetEngineDevice(ID id)
 	{
-		WAVE_ASSERT(s_Data != nullptr, "Wave not initialized!%s", "");
-		WAVE_ASSERT(s_Data->ActiveSoundGroups.contains(id), "Invalid Sound Group ID: '%zu'", uint64_t(id));
+		EngineInternalData* data = Utils::GetEngine(id);
+		WAVE_ASSERT(data != nullptr, "Invalid engine ID: '%zu'", uint64_t(id));
 
-		SoundGroupPair& pair = s_Data->ActiveSoundGroups[id];
-
-		return (void*)&pair.Data.Group;
+		return data != nullptr && data->HasDevice ? (void*)&data->Device : nullptr;
 	}
 
-	SoundGroupData* Context::GetSoundGroupInternalData(ID id)
+	Sequencer* Context::GetEngineSequencer(ID id)
 	{
-		WAVE_ASSERT(s_Data != nullptr, "Wave not initialized!%s", "");
-		WAVE_ASSERT(s_Data->ActiveSoundGroups.contains(id), "Invalid Sound Group ID: '%zu'", uint64_t(id));
+		EngineInternalData* data = Utils::GetEngine(id);
+		WAVE_ASSERT(data != nullptr, "Invalid engine ID: '%zu'", uint64_t(id));
 
-		SoundGroupPair& pair = s_Data->ActiveSoundGroups[id];
-
-		return &pair.Data.Data;
+		return data != nullptr ? data->Events.get() : nullptr;
 	}
 
-	void* Context::GetEngineInternal(ID id)
+	bool Context::ReadEngineFrames(ID id, float* output, uint64_t frameCount, uint64_t* framesRead)
 	{
-		WAVE_ASSERT(s_Data != nullptr, "Wave not initialized!%s", "");
-		WAVE_ASSERT(s_Data->ActiveEngines.contains(id), "Invalid engine ID: '%zu'", uint64_t(id));
-		
-		EnginePair& pair = s_Data->ActiveEngines[id];
-		
-		return (void*)&pair.Data.Engine;
+		EngineInternalData* data = Utils::GetEngine(id);
+		WAVE_ASSERT(data != nullptr, "Invalid engine ID: '%zu'", uint64_t(id));
+
+		if (data == nullptr)
+		{
+			SetLastError(ErrorCode::InvalidEngine, id);
+			return false;
+		}
+
+		ma_uint64 read = 0;
+		ma_result res = Utils::ReadEngineFrames(data->ContextData, data, output, frameCount, &read);
+
+		if (framesRead != nullptr)
+		{
+			*framesRead = read;
+		}
+
+		return res == MA_SUCCESS || res == MA_AT_END;
 	}
 
 	EngineData* Context::GetEngineInternalData(ID id)
 	{
-		WAVE_ASSERT(s_Data != nullptr, "Wave not initialized!%s", "");
-		WAVE_ASSERT(s_Data->ActiveEngines.contains(id), "Invalid engine ID: '%zu'", uint64_t(id));
+		EngineInternalData* data = Utils::GetEngine(id);
+		WAVE_ASSERT(data != nullptr, "Invalid engine ID: '%zu'", uint64_t(id));
 
-		EnginePair& pair = s_Data->ActiveEngines[id];
-		
-		return &pair.Data.Data;
+		return data != nullptr ? &data->Data : nullptr;
 	}
 
 	std::shared_ptr<Context> CreateContext()
@@ -3,16 +3,28 @@
 #include "Wave/Engine.h"
 #include "Wave/Sound.h"
 #include "Wave/SoundGroup.h"
+#include "Wave/DecodedSoundCache.h"
+#include "Wave/Error.h"
 #include "Wave/ID.h"
 
 #include <memory>
 #include <string>
 #include <vector>
+#include <span>
+#include <string_view>
 #include <functional>
 #include <filesystem>
 
 namespace Wave {
 
+	class SoundSpatialStore;
+	class SoundBank;
+	struct Command;
+	enum class DeferResult : uint8_t;
+	class CallbackProfiler;
+	class Sequencer;
+	struct InternalData;
+
 	enum class LogLevel : uint32_t
 	{
 		Info = 0, Warning, Error, Debug,
@@ -20,14 +32,58 @@ namespace Wave {
 
 	typedef void(*WaveLogCallback)(void*, uint32_t, const char*);
 
+	// Called from Context::Update once an asynchronously created sound has loaded (or failed to)
+	typedef void(*SoundLoadedCallback)(void*, ID, bool);
+
 	struct ContextSettings
 	{
 		WaveLogCallback LogCallback = nullptr;
 		bool EnumerateDevices = false;
 		bool EnableDebugLogging = false;
+
+		// Memory the decoded sound cache may keep resident, files that decode
+		// to more than this are streamed instead. Zero disables the cache.
+		size_t DecodedCacheBudget = 64 * 1024 * 1024;
+
+		// With SoundLoadMode::Auto, files that decode to more than this are streamed
+		size_t StreamingThreshold = 4 * 1024 * 1024;
+
+		// Threads opening sounds created with CreateSoundFromFileAsync
+		uint32_t LoaderThreadCount = 2;
+
+		// Records Sound, SoundGroup and Engine calls into a lock-free queue instead of running
+		// them on the calling thread, they're applied in order by ProcessCommands or Update
+		bool DeferCommands = false;
+		uint32_t CommandQueueCapacity = 8192; // Calls made while the queue is full are dropped, see GetDroppedCommandCount
+
+		// Every allocation the context makes goes through these when set, including the ones
+		// miniaudio makes for its context, engines, sounds, decoders and nodes
+		AllocationCallbacks Allocation;
+
+		// Slots allocated up front. Up to this many sounds, sound groups and engines can be
+		// alive at once without Wave allocating anything for their bookkeeping.
+		uint32_t ReservedSounds = 0;
+		uint32_t ReservedSoundGroups = 0;
+		uint32_t ReservedEngines = 0;
+
 		void* pUserData = nullptr;
 	};
 
+	/* See Context::CreateSoundPool. */
+	struct SoundPoolSettings
+	{
+		uint32_t WarmCount = 4;  /* Instances created up front, idle instances are never shrunk below this. */
+		uint32_t MaxIdle = 32;   /* Idle instances kept at most, sounds destroyed past this are freed as usual. */
+		uint32_t ShrinkDelayInMilliseconds = 5000; /* Unused this long, Update frees one idle instance above WarmCount per call. */
+	};
+
+	struct SoundPoolStats
+	{
+		uint32_t Idle = 0;
+		uint64_t Hits = 0;   /* Sounds created from an idle instance. */
+		uint64_t Misses = 0; /* Sounds created from scratch because the pool was empty. */
+	};
+
 	enum class DeviceType
 	{
 		Playback = 0, Capture,
@@ -38,6 +94,10 @@ namespace Wave {
 		std::string Name = "";
 		DeviceType Type;
 		bool IsDefault = false;
+
+		// Position in the context's device list, pass it as EngineSettings::PlaybackDeviceIndex.
+		// Devices are enumerated once in Init, so it stays valid for the context's lifetime.
+		uint32_t Index = 0;
 	};
 
 	struct ContextResult
@@ -47,39 +107,141 @@ namespace Wave {
 		bool Success = false;
 	};
 
+	// Contexts are independent of each other, each owns its engines, sounds, loader threads and
+	// caches and can be initialized and shut down on its own. Handles remember which context
+	// created them, calls on a handle only ever touch the state of that context.
 	class Context
 	{
 	public:
 		Context() = default;
 		~Context() = default;
 
+		Context(const Context&) = delete;
+		Context& operator=(const Context&) = delete;
+
 		ContextResult Init(const ContextSettings& settings);
 		bool Shutdown();
 
-		Sound CreateSoundFromFile(ID engineID, const std::filesystem::path& path);
-		Sound CreateSoundFromDataSource(ID engineID, const uint8_t* src, size_t size);
+		// Sounds created with a 'groupID' are mixed into that sound group instead of straight into the
+		// engine, the group must belong to the same engine
+		Sound CreateSoundFromFile(ID engineID, const std::filesystem::path& path, SoundLoadMode mode = SoundLoadMode::Auto, ID groupID = ID::Invalid);
+
+		// Returns a handle right away and opens the file on a loader thread. The sound reports
+		// SoundLoadState::Loading until a later Update() publishes the result, in the meantime
+		// its setters are recorded and applied on load and Play() is deferred until it's ready.
+		Sound CreateSoundFromFileAsync(ID engineID, const std::filesystem::path& path, SoundLoadMode mode = SoundLoadMode::Auto, SoundLoadedCallback callback = nullptr, void* userData = nullptr, ID groupID = ID::Invalid);
+		// Decodes directly from 'src' without copying it. The buffer is borrowed, it must stay
+		// valid and unchanged until the sound is destroyed, e.g. a memory-mapped archive.
+		Sound CreateSoundFromDataSource(ID engineID, const uint8_t* src, size_t size, ID groupID = ID::Invalid);
+
+		// Creates a sound from a sound bank entry, looked up by name or by SoundBank::HashName(name).
+		// Payloads are read from the bank's mapping, so the bank must outlive the sound.
+		Sound CreateSoundFromBank(ID engineID, const SoundBank& bank, std::string_view name, ID groupID = ID::Invalid);
+		Sound CreateSoundFromBank(ID engineID, const SoundBank& bank, uint64_t nameHash, ID groupID = ID::Invalid);
+
 		bool DestroySound(ID id);
 
+		// Decodes a file into the shared cache ahead of time and keeps it resident until
+		// unloaded, so the first CreateSoundFromFile for it doesn't decode on the spot
+		bool PreloadSound(const std::filesystem::path& path);
+		bool UnloadSound(const std::filesystem::path& path);
+
+		void SetDecodedCacheBudget(size_t budgetInBytes);
+		DecodedCacheStats GetDecodedCacheStats() const;
+
+		// Applies a frame's worth of sound parameter changes in a single pass,
+		// returns the number of entries that resolved to a live sound, or that were
+		// recorded when commands are deferred. Uses scratch space owned by the context,
+		// so call it from one thread at a time.
+		uint32_t UpdateSounds(std::span<const SoundUpdate> updates);
+
+		// Groups without a parent are mixed straight into the engine. Destroying a group hands its
+		// sounds and child groups over to its parent (or the engine) so they keep playing.
 		SoundGroup CreateSoundGroup(ID engineID, ID parentGroupID = ID::Invalid);
 		bool DestroySoundGroup(ID id);
 
-		Engine CreateEngine();
+		Engine CreateEngine(const EngineSettings& settings = EngineSettings());
+		// Async loads the engine hasn't started yet fail with ErrorCode::InvalidEngine, the ones
+		// already running are waited for. Sounds, sound groups and one-shot pools created on the
+		// engine are destroyed with it, handles to them go stale.
 		bool DestroyEngine(ID id);
 
-		inline const std::string& GetLastErrorMsg() const { return m_LastErrorMsg; }
+		// Keeps initialized instances of a file around for an engine. CreateSoundFromFile takes an idle one
+		// instead of initializing a new miniaudio sound, and DestroySound resets the sound and hands it back
+		// instead of uninitializing it. The file must fit the decoded sound cache, instances share its frames.
+		bool CreateSoundPool(ID engineID, const std::filesystem::path& path, const SoundPoolSettings& settings = SoundPoolSettings());
+		// Frees every idle instance, sounds still alive are destroyed as usual later on
+		bool DestroySoundPool(ID engineID, const std::filesystem::path& path);
+		SoundPoolStats GetSoundPoolStats(ID engineID, const std::filesystem::path& path) const;
+
+		// Initializes 'voiceCount' voices playing one file for Engine::PlayOneShot, returns the pool's ID or
+		// ID::Invalid. The file is fully decoded through the decoded sound cache, so it's shared with sounds
+		// created from it. Pools are destroyed with their engine.
+		ID CreateOneShotPool(ID engineID, const std::filesystem::path& path, uint32_t voiceCount, ID groupID = ID::Invalid);
+		bool DestroyOneShotPool(ID poolID);
+		OneShotPoolStats GetOneShotPoolStats(ID poolID) const;
+
+		// Per-frame maintenance, publishes sounds that finished loading asynchronously, retires sounds that
+		// played out, runs the attenuation pass and virtualizes or resumes voices for every engine with
+		// virtual voices enabled
+		void Update();
+
+		// Applies every deferred command recorded so far from the thread owning the context,
+		// returns the number applied. Only needed between updates, Update drains the queue first.
+		uint32_t ProcessCommands();
+
+		// Calls dropped because the queue was full when they were made, each recorded ErrorCode::CommandQueueFull
+		// on its thread and returned false (or 0 applied) where the call reports a result
+		uint64_t GetDroppedCommandCount() const;
+
+		// Errors are recorded per thread, not per context. These read the calling thread's last error,
+		// the message is only formatted here, failing calls never build one.
+		inline ErrorCode GetLastErrorCode() const { return GetLastError().Code; }
+		inline std::string GetLastErrorMsg() const { return FormatError(GetLastError()); }
 
 	private:
-		static void SetErrorMsg(const std::string& msg);
 
-		static void* GetSoundInternal(ID id);
+		// Stale handles resolve to null and record ErrorCode::InvalidSound. A sound that hasn't
+		// finished loading resolves with a null ma_sound, which miniaudio treats as a no-op.
 		static SoundData* GetSoundInternalData(ID id);
-		static void* GetSoundGroupInternal(ID id);
+		static bool ResolveSound(ID id, void** sound, SoundData** data);
+		static SoundSpatialStore* GetSoundSpatialStore(ID soundID);
+		SoundSpatialStore* GetSoundSpatialStore() const;
+		void PublishLoadedSounds();
+
+		// Anything but DeferResult::Immediate means the caller returns right away without running the call
+		static DeferResult DeferCommand(const Command& command);
+		bool IsDeferringCommands() const;
+		// Whether calls on 'id' are currently recorded by the context owning it
+		static bool IsDeferringCommands(ID id);
+		void ExecuteCommand(const Command& command);
+
+		static uint64_t GetVirtualCursor(ID soundID);
+		static void SetVirtualCursor(ID soundID, uint64_t cursor);
+		static bool DevirtualizeSound(ID soundID, bool resume);
+
+		static bool AcquireVoice(ID soundID);
+		static uint32_t CountActiveVoices(ID engineID);
+		static bool SetSoundOcclusion(ID id, float occlusion);
+		static bool PlayOneShot(ID engineID, ID poolID, const OneShotParams& params);
+		// Stale handles resolve to null and record ErrorCode::InvalidSoundGroup
 		static SoundGroupData* GetSoundGroupInternalData(ID id);
+		static bool ResolveSoundGroup(ID id, void** group, SoundGroupData** data);
+		// Drops destroyed sounds and child groups from a group's member lists
+		static void PruneSoundGroup(ID id);
+		static bool AddSoundGroupEffect(ID id, const BusEffect& effect);
+		static bool UpdateSoundGroupEffect(ID id, uint32_t index, const BusEffect& effect);
+		static void ClearSoundGroupEffects(ID id);
 		static void* GetEngineInternal(ID id);
 		static EngineData* GetEngineInternalData(ID id);
+		static CallbackProfiler* GetEngineProfiler(ID id);
+		static void* GetEngineDevice(ID id);
+		static Sequencer* GetEngineSequencer(ID id);
+		// Mixes the engine's next frames on the calling thread, applying due sequencer events on the way
+		static bool ReadEngineFrames(ID id, float* output, uint64_t frameCount, uint64_t* framesRead);
 
 	private:
-		std::string m_LastErrorMsg = "";
+		InternalData* m_Data = nullptr;
 
 	private:
 		friend class Engine;
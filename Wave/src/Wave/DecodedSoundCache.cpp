@@ -0,0 +1,281 @@
+#include "DecodedSoundCache.h"
+
+#include "Wave/Assert.h"
+#include "Wave/Error.h"
+
+#include <miniaudio/miniaudio.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Wave {
+
+	DecodedSoundCache::~DecodedSoundCache()
+	{
+		for (auto& [path, asset] : m_Assets)
+		{
+			m_Allocator->Free(asset->Frames);
+		}
+	}
+
+	void DecodedSoundCache::SetAllocator(Allocator* allocator)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		WAVE_ASSERT(m_Assets.empty(), "The decoded sound cache's allocator can't change while it holds assets!%s", "");
+
+		m_Allocator = allocator;
+		m_Assets = AssetMap(StlAllocator<AssetMap::value_type>(allocator));
+		m_IdleAssets = IdleList(StlAllocator<Asset*>(allocator));
+	}
+
+	DecodedSoundCache::Asset* DecodedSoundCache::Acquire(const std::string& path, size_t maxSizeInBytes, bool* tooLarge)
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		Asset* asset = FindOrDecode(lock, path, maxSizeInBytes, tooLarge);
+
+		if (asset == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (asset->Idle)
+		{
+			m_IdleAssets.erase(asset->IdlePosition);
+			asset->Idle = false;
+		}
+
+		asset->RefCount++;
+
+		return asset;
+	}
+
+	void DecodedSoundCache::Release(Asset* asset)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		if (--asset->RefCount == 0 && !asset->Pinned)
+		{
+			MakeIdle(asset);
+			Trim();
+		}
+	}
+
+	bool DecodedSoundCache::Preload(const std::string& path)
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		bool tooLarge = false;
+		Asset* asset = FindOrDecode(lock, path, SIZE_MAX, &tooLarge);
+
+		if (asset == nullptr)
+		{
+			return false;
+		}
+
+		if (asset->Idle)
+		{
+			m_IdleAssets.erase(asset->IdlePosition);
+			asset->Idle = false;
+		}
+
+		asset->Pinned = true;
+
+		return true;
+	}
+
+	bool DecodedSoundCache::Unload(const std::string& path)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		auto it = m_Assets.find(path);
+
+		if (it == m_Assets.end() || !it->second->Pinned)
+		{
+			return false;
+		}
+
+		Asset* asset = it->second.get();
+		asset->Pinned = false;
+
+		// Sounds still playing the asset keep it alive, it is evicted once they're destroyed
+		if (asset->RefCount == 0)
+		{
+			Evict(asset);
+		}
+
+		return true;
+	}
+
+	void DecodedSoundCache::SetBudget(size_t budgetInBytes)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		m_Budget = budgetInBytes;
+		Trim();
+	}
+
+	DecodedCacheStats DecodedSoundCache::GetStats()
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		DecodedCacheStats stats;
+		stats.SizeInBytes = m_Size;
+		stats.BudgetInBytes = m_Budget;
+		stats.AssetCount = (uint32_t)m_Assets.size();
+		stats.Hits = m_Hits;
+		stats.Misses = m_Misses;
+		stats.Evictions = m_Evictions;
+
+		return stats;
+	}
+
+	DecodedSoundCache::Asset* DecodedSoundCache::FindOrDecode(std::unique_lock<std::mutex>& lock, const std::string& path, size_t maxSizeInBytes, bool* tooLarge)
+	{
+		*tooLarge = false;
+
+		while (true)
+		{
+			auto it = m_Assets.find(path);
+
+			if (it == m_Assets.end())
+			{
+				break;
+			}
+
+			if (it->second->Ready)
+			{
+				m_Hits++;
+				return it->second.get();
+			}
+
+			// Another thread is decoding this file, wait for it rather than decoding it twice.
+			// Look it up again afterwards since a failed decode removes the entry.
+			m_AssetReady.wait(lock);
+		}
+
+		m_Misses++;
+
+		// Publish a placeholder so concurrent requests for the same file wait on this decode
+		AllocatedPtr<Asset> placeholder = MakeAllocated<Asset>(*m_Allocator);
+
+		if (placeholder == nullptr)
+		{
+			SetLastError(ErrorCode::OutOfMemory, ID::Invalid, 0, 0, "decoding a sound");
+			return nullptr;
+		}
+
+		placeholder->Path = path;
+		Asset* asset = placeholder.get();
+		m_Assets.emplace(path, std::move(placeholder));
+
+		// Decoding happens unlocked so loads of different files run in parallel
+		size_t budget = std::min(m_Budget, maxSizeInBytes);
+		lock.unlock();
+		bool decoded = Decode(asset, budget, tooLarge);
+		lock.lock();
+
+		if (!decoded)
+		{
+			m_Assets.erase(m_Assets.find(path));
+			m_AssetReady.notify_all();
+			return nullptr;
+		}
+
+		asset->Ready = true;
+		m_Size += asset->SizeInBytes;
+		m_AssetReady.notify_all();
+
+		// Make room for the new asset, it isn't idle so it can't evict itself
+		Trim();
+
+		return asset;
+	}
+
+	bool DecodedSoundCache::Decode(Asset* asset, size_t budget, bool* tooLarge)
+	{
+		const std::string& path = asset->Path;
+
+		ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
+		const AllocationCallbacks& callbacks = m_Allocator->GetCallbacks();
+		config.allocationCallbacks = { callbacks.pUserData, callbacks.Malloc, callbacks.Realloc, callbacks.Free };
+		ma_decoder decoder;
+
+		if (ma_decoder_init_file(path.c_str(), &config, &decoder) != MA_SUCCESS)
+		{
+			SetLastError(ErrorCode::DecodeFailed, ID::Invalid, 0, 0, path);
+			return false;
+		}
+
+		// Check the size before decoding anything so long music tracks are turned away cheaply
+		ma_uint64 frameCount = 0;
+		ma_decoder_get_length_in_pcm_frames(&decoder, &frameCount);
+		size_t bytesPerFrame = sizeof(float) * decoder.outputChannels;
+		size_t sizeInBytes = (size_t)frameCount * bytesPerFrame;
+
+		if (frameCount == 0 || sizeInBytes > budget)
+		{
+			ma_decoder_uninit(&decoder);
+			*tooLarge = true;
+			SetLastError(ErrorCode::TooLargeForCache, ID::Invalid, sizeInBytes, budget, path);
+			return false;
+		}
+
+		float* frames = (float*)m_Allocator->Allocate(sizeInBytes);
+
+		if (frames == nullptr)
+		{
+			ma_decoder_uninit(&decoder);
+			SetLastError(ErrorCode::OutOfMemory, ID::Invalid, 0, 0, "decoding a sound");
+			return false;
+		}
+
+		ma_uint64 framesRead = 0;
+		ma_decoder_read_pcm_frames(&decoder, frames, frameCount, &framesRead);
+
+		asset->Frames = frames;
+		asset->FrameCount = framesRead;
+		asset->Channels = decoder.outputChannels;
+		asset->SampleRate = decoder.outputSampleRate;
+		asset->SizeInBytes = sizeInBytes;
+
+		ma_decoder_uninit(&decoder);
+
+		return true;
+	}
+
+	void DecodedSoundCache::MakeIdle(Asset* asset)
+	{
+		m_IdleAssets.push_front(asset);
+		asset->IdlePosition = m_IdleAssets.begin();
+		asset->Idle = true;
+	}
+
+	void DecodedSoundCache::Evict(Asset* asset)
+	{
+		if (asset->Idle)
+		{
+			m_IdleAssets.erase(asset->IdlePosition);
+		}
+
+		m_Size -= asset->SizeInBytes;
+		m_Evictions++;
+
+		m_Allocator->Free(asset->Frames);
+
+		// The key lives inside the asset, so erase through the iterator rather than by key
+		m_Assets.erase(m_Assets.find(asset->Path));
+	}
+
+	void DecodedSoundCache::Trim()
+	{
+		// Referenced and preloaded assets are never idle, so the budget is
+		// only a soft limit while more than it is actually in use
+		while (m_Size > m_Budget && !m_IdleAssets.empty())
+		{
+			Evict(m_IdleAssets.back());
+		}
+	}
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Wave/Allocator.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Wave {
+
+	struct DecodedCacheStats
+	{
+		size_t SizeInBytes = 0;
+		size_t BudgetInBytes = 0;
+		uint32_t AssetCount = 0;
+		uint32_t Hits = 0;
+		uint32_t Misses = 0;
+		uint32_t Evictions = 0;
+	};
+
+	// Fully decoded sounds shared between every sound created from the same file.
+	// Assets are reference counted by the sounds playing them, once unreferenced (and
+	// not preloaded) they stay resident until the budget is exceeded and are then
+	// evicted least recently used first. Files are decoded outside the lock, so loader
+	// threads only ever wait on each other when they ask for the same file.
+	class DecodedSoundCache
+	{
+	public:
+		struct Asset;
+		using IdleList = std::list<Asset*, StlAllocator<Asset*>>;
+
+		struct Asset
+		{
+			std::string Path = "";
+			float* Frames = nullptr; /* Interleaved f32 at the file's native rate and channel count. */
+			uint64_t FrameCount = 0;
+			uint32_t Channels = 0;
+			uint32_t SampleRate = 0;
+			size_t SizeInBytes = 0;
+
+			uint32_t RefCount = 0;
+			bool Ready = false; /* False while a thread is still decoding it. */
+			bool Pinned = false;
+			bool Idle = false;
+			IdleList::iterator IdlePosition;
+		};
+
+	public:
+		DecodedSoundCache() = default;
+		~DecodedSoundCache();
+
+		DecodedSoundCache(const DecodedSoundCache&) = delete;
+		DecodedSoundCache& operator=(const DecodedSoundCache&) = delete;
+
+		// Assets, their frames and the decoders are allocated through this, must be set while the cache is empty
+		void SetAllocator(Allocator* allocator);
+
+		// Returns a referenced asset, decoding the file on a miss. Returns nullptr with 'tooLarge' set when
+		// the decoded file would exceed 'maxSizeInBytes' or the budget, the caller should stream it instead.
+		// Failures are reported through the calling thread's last error.
+		Asset* Acquire(const std::string& path, size_t maxSizeInBytes, bool* tooLarge);
+		void Release(Asset* asset);
+
+		// Preloaded assets are never evicted until unloaded
+		bool Preload(const std::string& path);
+		bool Unload(const std::string& path);
+
+		void SetBudget(size_t budgetInBytes);
+		DecodedCacheStats GetStats();
+
+	private:
+		Asset* FindOrDecode(std::unique_lock<std::mutex>& lock, const std::string& path, size_t maxSizeInBytes, bool* tooLarge);
+		bool Decode(Asset* asset, size_t budget, bool* tooLarge);
+		void MakeIdle(Asset* asset);
+		void Evict(Asset* asset);
+		void Trim();
+
+	private:
+		std::mutex m_Mutex;
+		std::condition_variable m_AssetReady;
+		using AssetMap = std::unordered_map<std::string, AllocatedPtr<Asset>, std::hash<std::string>, std::equal_to<std::string>, StlAllocator<std::pair<const std::string, AllocatedPtr<Asset>>>>;
+
+		Allocator* m_Allocator = &Allocator::GetDefault();
+		AssetMap m_Assets;
+		IdleList m_IdleAssets; // Most recently used at the front
+
+		size_t m_Size = 0;
+		size_t m_Budget = 0;
+		uint32_t m_Hits = 0;
+		uint32_t m_Misses = 0;
+		uint32_t m_Evictions = 0;
+	};
+
+}
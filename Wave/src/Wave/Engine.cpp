@@ -2,25 +2,49 @@
 
 #include "Wave/Context.h"
 #include "Wave/Assert.h"
+#include "Wave/CommandQueue.h"
+#include "Wave/CallbackProfiler.h"
+#include "Wave/Sequencer.h"
 
 #include <miniaudio/miniaudio.h>
 
-#include <format>
+#include <vector>
 
 namespace Wave {
 
+	static_assert(MaxListeners == MA_ENGINE_MAX_LISTENERS, "MaxListeners must match miniaudio's listener limit");
+
+	namespace Utils {
+
+		static bool Equal(const Vec3& a, const Vec3& b)
+		{
+			return a.X == b.X && a.Y == b.Y && a.Z == b.Z;
+		}
+
+	}
+
 	bool Engine::Start() const
 	{
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::EngineStart, m_EngineID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
 		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
 		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
 		WAVE_ASSERT(!Context::GetEngineInternalData(m_EngineID)->IsRunning, "Engine must be stopped to start it!%s", "");
+
+		if (Context::GetEngineInternalData(m_EngineID)->IsOffline)
+		{
+			SetLastError(ErrorCode::EngineOffline, m_EngineID);
+			return false;
+		}
+
+		Context::GetEngineProfiler(m_EngineID)->MarkStarted();
 		
 		ma_result res = ma_engine_start(engine);
 		
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to start engine with ID: '{}'", uint64_t(m_EngineID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::StartFailed, m_EngineID, 0, 0, "engine");
 			return false;
 		}
 
@@ -31,6 +55,9 @@ namespace Wave {
 
 	bool Engine::Stop() const
 	{
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::EngineStop, m_EngineID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
 		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
 		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
 		WAVE_ASSERT(Context::GetEngineInternalData(m_EngineID)->IsRunning, "Engine must be running to stop it!%s", "");
@@ -39,8 +66,7 @@ namespace Wave {
 		
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to stop engine with ID: '{}'", uint64_t(m_EngineID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::StopFailed, m_EngineID, 0, 0, "engine");
 			Context::GetEngineInternalData(m_EngineID)->IsRunning = false;
 			return false;
 		}
@@ -57,4 +83,452 @@ namespace Wave {
 		return Context::GetEngineInternalData(m_EngineID)->IsRunning;
 	}
 
+	bool Engine::IsOffline() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+		return Context::GetEngineInternalData(m_EngineID)->IsOffline;
+	}
+
+	uint32_t Engine::GetChannelCount() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+		return ma_engine_get_channels(engine);
+	}
+
+	uint32_t Engine::GetSampleRate() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+		return ma_engine_get_sample_rate(engine);
+	}
+
+	uint32_t Engine::GetPeriodSizeInFrames() const
+	{
+		ma_device* device = (ma_device*)Context::GetEngineDevice(m_EngineID);
+
+		return device != nullptr ? device->playback.internalPeriodSizeInFrames : 0;
+	}
+
+	uint32_t Engine::GetPeriods() const
+	{
+		ma_device* device = (ma_device*)Context::GetEngineDevice(m_EngineID);
+
+		return device != nullptr ? device->playback.internalPeriods : 0;
+	}
+
+	uint64_t Engine::Render(float* output, uint64_t frameCount) const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+		WAVE_ASSERT(output != nullptr || frameCount == 0, "Render output must not be null!%s", "");
+
+		if (!Context::GetEngineInternalData(m_EngineID)->IsOffline)
+		{
+			SetLastError(ErrorCode::EngineNotOffline, m_EngineID);
+			return 0;
+		}
+
+		CallbackProfiler* profiler = Context::GetEngineProfiler(m_EngineID);
+		uint64_t start = CallbackProfiler::GetTime();
+
+		uint64_t framesRead = 0;
+		bool success = Context::ReadEngineFrames(m_EngineID, output, frameCount, &framesRead);
+
+		profiler->Record(start, CallbackProfiler::GetTime(), (uint32_t)frameCount);
+
+		if (!success)
+		{
+			SetLastError(ErrorCode::RenderFailed, m_EngineID);
+		}
+
+		return framesRead;
+	}
+
+	bool Engine::RenderToFile(const std::filesystem::path& path, uint64_t frameCount) const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		uint32_t channels = ma_engine_get_channels(engine);
+		ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, channels, ma_engine_get_sample_rate(engine));
+		ma_encoder encoder;
+
+		if (ma_encoder_init_file(path.string().c_str(), &config, &encoder) != MA_SUCCESS)
+		{
+			SetLastError(ErrorCode::FileWriteFailed, m_EngineID, 0, 0, path.string());
+			return false;
+		}
+
+		// Rendered in blocks so memory stays flat however long the bounce is
+		constexpr uint64_t BlockSize = 4096;
+		std::vector<float> block(BlockSize * channels);
+		bool success = true;
+
+		while (frameCount > 0)
+		{
+			uint64_t framesToRender = frameCount < BlockSize ? frameCount : BlockSize;
+			uint64_t framesRendered = Render(block.data(), framesToRender);
+
+			if (framesRendered != framesToRender || ma_encoder_write_pcm_frames(&encoder, block.data(), framesRendered, nullptr) != MA_SUCCESS)
+			{
+				success = false;
+				break;
+			}
+
+			frameCount -= framesRendered;
+		}
+
+		ma_encoder_uninit(&encoder);
+
+		if (!success)
+		{
+			SetLastError(ErrorCode::RenderFailed, m_EngineID, 0, 0, path.string());
+		}
+
+		return success;
+	}
+
+	uint32_t Engine::GetListenerCount() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return Context::GetEngineInternalData(m_EngineID)->ListenerCount;
+	}
+
+	const ListenerState& Engine::GetListener(uint32_t listenerIndex) const
+	{
+		EngineData* data = Context::GetEngineInternalData(m_EngineID);
+		WAVE_ASSERT(listenerIndex < data->ListenerCount, "Invalid listener index: '%u'", listenerIndex);
+
+		return data->Listeners[listenerIndex];
+	}
+
+	void Engine::SetListenerPosition(uint32_t listenerIndex, const Vec3& position) const
+	{
+		ListenerUpdate update;
+		update.ListenerIndex = listenerIndex;
+		update.Position = position;
+		update.Flags = (uint32_t)ListenerUpdateFlags::Position;
+
+		UpdateListeners({ &update, 1 });
+	}
+
+	void Engine::SetListenerDirection(uint32_t listenerIndex, const Vec3& direction) const
+	{
+		ListenerUpdate update;
+		update.ListenerIndex = listenerIndex;
+		update.Direction = direction;
+		update.Flags = (uint32_t)ListenerUpdateFlags::Direction;
+
+		UpdateListeners({ &update, 1 });
+	}
+
+	void Engine::SetListenerVelocity(uint32_t listenerIndex, const Vec3& velocity) const
+	{
+		ListenerUpdate update;
+		update.ListenerIndex = listenerIndex;
+		update.Velocity = velocity;
+		update.Flags = (uint32_t)ListenerUpdateFlags::Velocity;
+
+		UpdateListeners({ &update, 1 });
+	}
+
+	void Engine::SetListenerWorldUp(uint32_t listenerIndex, const Vec3& worldUp) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::EngineSetListenerWorldUp, m_EngineID, { worldUp.X, worldUp.Y, worldUp.Z }, { listenerIndex })) != DeferResult::Immediate)
+			return;
+
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		EngineData* data = Context::GetEngineInternalData(m_EngineID);
+		WAVE_ASSERT(listenerIndex < data->ListenerCount, "Invalid listener index: '%u'", listenerIndex);
+
+		ma_engine_listener_set_world_up(engine, listenerIndex, worldUp.X, worldUp.Y, worldUp.Z);
+		data->Listeners[listenerIndex].WorldUp = worldUp;
+	}
+
+	void Engine::SetListenerCone(uint32_t listenerIndex, const AudioCone& cone) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::EngineSetListenerCone, m_EngineID, { cone.InnerAngle, cone.OuterAngle, cone.OuterGain }, { listenerIndex })) != DeferResult::Immediate)
+			return;
+
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		EngineData* data = Context::GetEngineInternalData(m_EngineID);
+		WAVE_ASSERT(listenerIndex < data->ListenerCount, "Invalid listener index: '%u'", listenerIndex);
+
+		ma_engine_listener_set_cone(engine, listenerIndex, cone.InnerAngle, cone.OuterAngle, cone.OuterGain);
+		data->Listeners[listenerIndex].Cone = cone;
+	}
+
+	void Engine::SetListenerEnabled(uint32_t listenerIndex, bool enabled) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::EngineSetListenerEnabled, m_EngineID, {}, { listenerIndex, (uint64_t)enabled })) != DeferResult::Immediate)
+			return;
+
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		EngineData* data = Context::GetEngineInternalData(m_EngineID);
+		WAVE_ASSERT(listenerIndex < data->ListenerCount, "Invalid listener index: '%u'", listenerIndex);
+
+		ma_engine_listener_set_enabled(engine, listenerIndex, (ma_bool32)enabled);
+		data->Listeners[listenerIndex].Enabled = enabled;
+	}
+
+	uint32_t Engine::UpdateListeners(std::span<const ListenerUpdate> updates) const
+	{
+		if (Context::IsDeferringCommands(m_EngineID))
+		{
+			uint32_t queued = 0;
+
+			for (const ListenerUpdate& update : updates)
+			{
+				Command command = MakeCommand(CommandType::EngineUpdateListener, m_EngineID,
+					{ update.Position.X, update.Position.Y, update.Position.Z, update.Direction.X, update.Direction.Y, update.Direction.Z, update.Velocity.X, update.Velocity.Y, update.Velocity.Z },
+					{ update.ListenerIndex });
+				command.Flags = update.Flags;
+
+				// Same as Context::UpdateSounds, entries dropped on a full queue aren't counted
+				if (Context::DeferCommand(command) == DeferResult::Queued)
+				{
+					queued++;
+				}
+			}
+
+			return queued;
+		}
+
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		EngineData* data = Context::GetEngineInternalData(m_EngineID);
+		uint32_t applied = 0;
+
+		for (const ListenerUpdate& update : updates)
+		{
+			if (update.ListenerIndex >= data->ListenerCount)
+			{
+				continue;
+			}
+
+			ListenerState& listener = data->Listeners[update.ListenerIndex];
+			applied++;
+
+			// Listeners that didn't move since the last frame don't touch the spatializer
+			if ((update.Flags & (uint32_t)ListenerUpdateFlags::Position) && !Utils::Equal(listener.Position, update.Position))
+			{
+				ma_engine_listener_set_position(engine, update.ListenerIndex, update.Position.X, update.Position.Y, update.Position.Z);
+				listener.Position = update.Position;
+			}
+
+			if ((update.Flags & (uint32_t)ListenerUpdateFlags::Direction) && !Utils::Equal(listener.Direction, update.Direction))
+			{
+				ma_engine_listener_set_direction(engine, update.ListenerIndex, update.Direction.X, update.Direction.Y, update.Direction.Z);
+				listener.Direction = update.Direction;
+			}
+
+			if ((update.Flags & (uint32_t)ListenerUpdateFlags::Velocity) && !Utils::Equal(listener.Velocity, update.Velocity))
+			{
+				ma_engine_listener_set_velocity(engine, update.ListenerIndex, update.Velocity.X, update.Velocity.Y, update.Velocity.Z);
+				listener.Velocity = update.Velocity;
+			}
+		}
+
+		return applied;
+	}
+
+	uint32_t Engine::FindClosestListener(const Vec3& position) const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return (uint32_t)ma_engine_find_closest_listener(engine, position.X, position.Y, position.Z);
+	}
+
+	const OcclusionSettings& Engine::GetOcclusionSettings() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return Context::GetEngineInternalData(m_EngineID)->Occlusion;
+	}
+
+	void Engine::SetOcclusionSettings(const OcclusionSettings& settings) const
+	{
+		Command command = MakeCommand(CommandType::EngineSetOcclusionSettings, m_EngineID,
+			{ (float)settings.BatchIntervalInMilliseconds, settings.MinCutoffFrequency, settings.MaxCutoffFrequency, settings.OccludedGain },
+			{ (uint64_t)settings.QueryCallback, (uint64_t)settings.pUserData });
+		command.Flags = settings.MaxQueriesPerBatch;
+
+		if (Context::DeferCommand(command) != DeferResult::Immediate)
+			return;
+
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+		WAVE_ASSERT(settings.MinCutoffFrequency <= settings.MaxCutoffFrequency, "Occlusion min cutoff must not be above the max cutoff!%s", "");
+
+		// Filters already in place pick the new range up on their sound's next occlusion change
+		Context::GetEngineInternalData(m_EngineID)->Occlusion = settings;
+	}
+
+	const VirtualVoiceSettings& Engine::GetVirtualVoiceSettings() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return Context::GetEngineInternalData(m_EngineID)->VirtualVoices;
+	}
+
+	void Engine::SetVirtualVoiceSettings(const VirtualVoiceSettings& settings) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::EngineSetVirtualVoiceSettings, m_EngineID, { settings.VirtualizeGain, settings.RealizeGain }, { (uint64_t)settings.Enabled })) != DeferResult::Immediate)
+			return;
+
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+		WAVE_ASSERT(settings.RealizeGain >= settings.VirtualizeGain, "Realize gain must not be below the virtualize gain!%s", "");
+
+		Context::GetEngineInternalData(m_EngineID)->VirtualVoices = settings;
+	}
+
+	uint32_t Engine::GetVirtualVoiceCount() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return Context::GetEngineInternalData(m_EngineID)->VirtualVoiceCount;
+	}
+
+	const VoiceLimitSettings& Engine::GetVoiceLimitSettings() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return Context::GetEngineInternalData(m_EngineID)->VoiceLimit;
+	}
+
+	void Engine::SetVoiceLimitSettings(const VoiceLimitSettings& settings) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::EngineSetVoiceLimitSettings, m_EngineID, {}, { settings.MaxVoices, settings.StealFadeInMilliseconds })) != DeferResult::Immediate)
+			return;
+
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		Context::GetEngineInternalData(m_EngineID)->VoiceLimit = settings;
+	}
+
+	bool Engine::PlayOneShot(ID poolID, const OneShotParams& params) const
+	{
+		return Context::PlayOneShot(m_EngineID, poolID, params);
+	}
+
+	uint64_t Engine::GetTimeInPCMFrames() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return ma_engine_get_time_in_pcm_frames(engine);
+	}
+
+	bool Engine::Schedule(const SequencerEvent& event) const
+	{
+		return Schedule({ &event, 1 }) == 1;
+	}
+
+	uint32_t Engine::Schedule(std::span<const SequencerEvent> events) const
+	{
+		Sequencer* sequencer = Context::GetEngineSequencer(m_EngineID);
+
+		if (sequencer == nullptr)
+		{
+			SetLastError(ErrorCode::NoSequencer, m_EngineID);
+			return 0;
+		}
+
+		// Pushed straight to the audio thread, so unlike most calls these are never deferred
+		uint32_t scheduled = 0;
+
+		for (const SequencerEvent& event : events)
+		{
+			if (!sequencer->Push(event))
+			{
+				SetLastError(ErrorCode::SequencerFull, m_EngineID);
+				break;
+			}
+
+			scheduled++;
+		}
+
+		return scheduled;
+	}
+
+	void Engine::ClearSchedule() const
+	{
+		Sequencer* sequencer = Context::GetEngineSequencer(m_EngineID);
+
+		if (sequencer != nullptr)
+		{
+			sequencer->Clear();
+		}
+	}
+
+	SequencerStats Engine::GetSequencerStats() const
+	{
+		Sequencer* sequencer = Context::GetEngineSequencer(m_EngineID);
+
+		return sequencer != nullptr ? sequencer->GetStats() : SequencerStats();
+	}
+
+	CallbackStats Engine::GetCallbackStats() const
+	{
+		CallbackProfiler* profiler = Context::GetEngineProfiler(m_EngineID);
+		WAVE_ASSERT(profiler, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		return profiler != nullptr ? profiler->GetStats() : CallbackStats();
+	}
+
+	void Engine::ResetCallbackStats() const
+	{
+		CallbackProfiler* profiler = Context::GetEngineProfiler(m_EngineID);
+		WAVE_ASSERT(profiler, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		if (profiler != nullptr)
+		{
+			profiler->Reset();
+		}
+	}
+
+	bool Engine::WriteCallbackTrace(const std::filesystem::path& path) const
+	{
+		CallbackProfiler* profiler = Context::GetEngineProfiler(m_EngineID);
+		WAVE_ASSERT(profiler, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		ErrorCode code = profiler != nullptr ? profiler->WriteChromeTrace(path) : ErrorCode::InvalidEngine;
+
+		if (code != ErrorCode::None)
+		{
+			SetLastError(code, m_EngineID, 0, 0, code == ErrorCode::FileWriteFailed ? path.string() : std::string());
+			return false;
+		}
+
+		return true;
+	}
+
+	VoiceStats Engine::GetVoiceStats() const
+	{
+		ma_engine* engine = (ma_engine*)Context::GetEngineInternal(m_EngineID);
+		WAVE_ASSERT(engine, "Invalid engine ID: '%zu'", uint64_t(m_EngineID));
+
+		EngineData* data = Context::GetEngineInternalData(m_EngineID);
+
+		VoiceStats stats;
+		stats.ActiveVoices = Context::CountActiveVoices(m_EngineID);
+		stats.VirtualVoices = data->VirtualVoiceCount;
+		stats.Steals = data->VoiceSteals;
+		stats.Rejections = data->VoiceRejections;
+
+		return stats;
+	}
+
 }
@@ -1,12 +1,207 @@
 #pragma once
 
+#include "Wave/Types.h"
 #include "Wave/ID.h"
 
+#include <filesystem>
+#include <span>
+#include <vector>
+
 namespace Wave {
 
+	struct VirtualVoiceSettings
+	{
+		bool Enabled = false;
+		float VirtualizeGain = 0.001f; /* Voices quieter than this (-60 dB) stop being mixed. */
+		float RealizeGain = 0.002f;    /* Virtual voices louder than this are mixed again, the gap avoids flip-flopping. */
+	};
+
+	struct VoiceLimitSettings
+	{
+		uint32_t MaxVoices = 0;              /* Maximum number of sounds mixed at once, 0 means unlimited. */
+		uint32_t StealFadeInMilliseconds = 10; /* Fade applied to a voice that gets stolen to avoid clicks. */
+	};
+
+	struct VoiceStats
+	{
+		uint32_t ActiveVoices = 0;
+		uint32_t VirtualVoices = 0;
+		uint64_t Steals = 0;
+		uint64_t Rejections = 0;
+	};
+
+	/* One line of sight check for an OcclusionQueryCallback. */
+	struct OcclusionQuery
+	{
+		ID SoundID = ID::Invalid;
+		Vec3 SoundPosition = Vec3(0.0f);
+		Vec3 ListenerPosition = Vec3(0.0f); /* The listener the sound is heard by. */
+		uint32_t ListenerIndex = 0;
+	};
+
+	// Called on a worker thread with a batch of queries, writes one occlusion value per query to
+	// 'results', 0 for a clear line of sight up to 1 for fully blocked. Runs while the game keeps
+	// going, so it must only read state that's safe to read from another thread (e.g. the physics scene).
+	typedef void(*OcclusionQueryCallback)(void*, const OcclusionQuery* queries, float* results, uint32_t count);
+
+	struct OcclusionSettings
+	{
+		// Without a callback occlusion is only what's set with Sound::SetOcclusion
+		OcclusionQueryCallback QueryCallback = nullptr;
+		void* pUserData = nullptr;
+
+		uint32_t MaxQueriesPerBatch = 256;    /* Playing sounds queried per batch, the rest wait for the next batches round-robin. */
+		uint32_t BatchIntervalInMilliseconds = 50; /* Minimum time between two batches. */
+
+		float MinCutoffFrequency = 500.0f;    /* Low-pass cutoff of a fully occluded sound. */
+		float MaxCutoffFrequency = 20000.0f;  /* Cutoff of an unoccluded sound, clamped below Nyquist. */
+		float OccludedGain = 0.35f;           /* Gain of a fully occluded sound, on top of its volume. */
+	};
+
+	enum class SequencerEventType : uint8_t
+	{
+		Play = 0,
+		Stop,      /* Stops and rewinds, like Sound::Stop. */
+		SetVolume,
+		SetPitch,
+		SetPan,
+		Fade,      /* Fades from FadeFrom to Value over FadeLengthInPCMFrames. */
+	};
+
+	/* A change to a sound at an exact engine time, see Engine::Schedule. */
+	struct SequencerEvent
+	{
+		SequencerEventType Type = SequencerEventType::Play;
+		ID SoundID = ID::Invalid;
+		uint64_t TimeInPCMFrames = 0;       /* Absolute engine time, events already due fire at the start of the next period. */
+		float Value = 1.0f;                 /* SetVolume, SetPitch, SetPan and the volume a Fade ends on. */
+		float FadeFrom = -1.0f;             /* Fade only, -1 starts from the current fade volume. */
+		uint64_t FadeLengthInPCMFrames = 0; /* Fade only. */
+	};
+
+	struct SequencerStats
+	{
+		uint32_t Pending = 0; /* Collected by the audio thread and not due yet. */
+		uint64_t Fired = 0;
+		uint64_t Dropped = 0; /* Rejected by Engine::Schedule because the sequencer was full. */
+	};
+
+	enum class PerformanceProfile : uint8_t
+	{
+		LowLatency = 0, /* Small periods by default, for games and interactive use. */
+		Conservative,   /* Larger default periods that are less likely to glitch on slow or virtualized hardware. */
+	};
+
+	enum class ShareMode : uint8_t
+	{
+		Shared = 0,
+		Exclusive, /* Bypasses the system mixer where the backend supports it (WASAPI), creation fails when the device is in use. */
+	};
+
+	/* Per-play settings for Engine::PlayOneShot. */
+	struct OneShotParams
+	{
+		Vec3 Position = Vec3(0.0f);
+		float Volume = 1.0f;
+		float Pitch = 1.0f;
+		float Pan = 0.0f;
+		bool Spacialized = false; /* Plays at Position when set, otherwise straight to the output like UI sounds. */
+	};
+
+	struct OneShotPoolStats
+	{
+		uint32_t VoiceCount = 0;
+		uint32_t FreeVoices = 0;
+		uint64_t Plays = 0;
+		uint64_t Rejections = 0; /* Plays that found every voice busy. */
+	};
+
+	struct EngineSettings
+	{
+		// Skips the playback device, the mix is pulled explicitly with Engine::Render
+		// as fast as the CPU allows, for tests, servers and offline bouncing
+		bool Offline = false;
+
+		uint32_t Channels = 0;   /* 0 uses the device's channel count, or stereo when offline. */
+		uint32_t SampleRate = 0; /* 0 uses the device's sample rate, or 48 kHz when offline. */
+
+		// The rest only applies to engines with a device
+		int32_t PlaybackDeviceIndex = -1; /* DeviceInfo::Index of the device to open, -1 opens the system default. */
+		uint32_t PeriodSizeInFrames = 0;  /* Frames mixed per callback, 0 lets the profile pick. Backends may round it. */
+		uint32_t Periods = 0;             /* Periods in the device's buffer, 0 lets the backend pick. */
+		PerformanceProfile Profile = PerformanceProfile::LowLatency;
+		ShareMode Mode = ShareMode::Shared;
+
+		// Number of most recent callbacks kept for Engine::WriteCallbackTrace, 0 disables tracing
+		uint32_t CallbackTraceCapacity = 0;
+
+		// One per local player for split-screen, up to MaxListeners
+		uint32_t ListenerCount = 1;
+
+		// Events Engine::Schedule can hold at once, 0 disables the sequencer
+		uint32_t SequencerCapacity = 4096;
+	};
+
+	struct ListenerState
+	{
+		Vec3 Position = Vec3(0.0f);
+		Vec3 Direction = Vec3(0.0f, 0.0f, -1.0f);
+		Vec3 Velocity = Vec3(0.0f);
+		Vec3 WorldUp = Vec3(0.0f, 1.0f, 0.0f);
+		AudioCone Cone = { 6.283185f, 6.283185f, 0.0f }; /* Omnidirectional, like a fresh miniaudio listener. */
+		bool Enabled = true;
+	};
+
+	enum class ListenerUpdateFlags : uint32_t
+	{
+		None      = 0,
+		Position  = 1 << 0,
+		Direction = 1 << 1,
+		Velocity  = 1 << 2,
+		All       = Position | Direction | Velocity,
+	};
+
+	/* A single entry for Engine::UpdateListeners, only the fields selected by Flags are applied. */
+	struct ListenerUpdate
+	{
+		uint32_t ListenerIndex = 0;
+		Vec3 Position = Vec3(0.0f);
+		Vec3 Direction = Vec3(0.0f, 0.0f, -1.0f);
+		Vec3 Velocity = Vec3(0.0f);
+		uint32_t Flags = (uint32_t)ListenerUpdateFlags::All;
+	};
+
+	struct CallbackStats
+	{
+		uint64_t Callbacks = 0;
+		float MinMilliseconds = 0.0f;
+		float AvgMilliseconds = 0.0f;
+		float P99Milliseconds = 0.0f;  /* 10 us resolution. */
+		float MaxMilliseconds = 0.0f;
+		float BudgetMilliseconds = 0.0f; /* Length of the latest period, how long a callback may take before the device runs dry. */
+		float BudgetUtilization = 0.0f;  /* Processing time over the time available, at 1 or above the mix can't keep up. */
+		uint64_t Overruns = 0;           /* Callbacks that took longer than their period. */
+		uint64_t Xruns = 0;              /* Callbacks that arrived over two periods after the previous one, the device most likely starved. */
+		uint32_t ActiveVoices = 0;       /* As of the last Context::Update. */
+	};
+
 	struct EngineData
 	{
 		bool IsRunning = false;
+		bool IsOffline = false;
+
+		VirtualVoiceSettings VirtualVoices;
+		uint32_t VirtualVoiceCount = 0;
+
+		VoiceLimitSettings VoiceLimit;
+		std::vector<ID> Voices; // Sounds started on this engine, pruned lazily as they finish
+		uint64_t VoiceSteals = 0;
+		uint64_t VoiceRejections = 0;
+
+		uint32_t ListenerCount = 1;
+		ListenerState Listeners[MaxListeners];
+
+		OcclusionSettings Occlusion;
 	};
 
 	class Engine
@@ -19,6 +214,86 @@ namespace Wave {
 		bool Stop() const;
 
 		bool IsRunning() const;
+		bool IsOffline() const;
+
+		uint32_t GetChannelCount() const;
+		uint32_t GetSampleRate() const;
+
+		// What the device actually runs at, which may differ from what EngineSettings asked for.
+		// Both are 0 for offline engines.
+		uint32_t GetPeriodSizeInFrames() const;
+		uint32_t GetPeriods() const;
+
+		// Offline engines only. Mixes the next 'frameCount' frames of everything playing on the engine
+		// into 'output' (interleaved f32, GetChannelCount() samples per frame) and advances the engine's
+		// clock by as much, returns the number of frames rendered
+		uint64_t Render(float* output, uint64_t frameCount) const;
+		// Renders the next 'frameCount' frames into a 32-bit float WAV file
+		bool RenderToFile(const std::filesystem::path& path, uint64_t frameCount) const;
+
+		// Starts a free voice of a pool made with Context::CreateOneShotPool, the voice goes back to the pool on
+		// the first Context::Update after it reaches its end. Safe to call from any thread, never allocates or waits on a lock and
+		// isn't deferred. One-shots don't count against the voice limit and are never virtualized, when every
+		// voice of the pool is busy the play is dropped and counted in OneShotPoolStats::Rejections.
+		bool PlayOneShot(ID poolID, const OneShotParams& params = OneShotParams()) const;
+
+		// The engine's clock, advanced by the audio thread (or Render) as frames are mixed
+		uint64_t GetTimeInPCMFrames() const;
+
+		// Queues an event to be applied on the audio thread at exactly its frame, the mix is split
+		// around it. Safe to call from any thread, fails when the sequencer is full or disabled.
+		// Scheduled plays don't steal voices and events for sounds still loading are dropped.
+		bool Schedule(const SequencerEvent& event) const;
+		// Returns the number of events queued, stops at the first one that didn't fit
+		uint32_t Schedule(std::span<const SequencerEvent> events) const;
+		// Drops every event that hasn't fired yet, applied on the next period
+		void ClearSchedule() const;
+		SequencerStats GetSequencerStats() const;
+
+		// Timing of the audio callback (of Render for offline engines), collected on the audio
+		// thread without locking and readable from any thread
+		CallbackStats GetCallbackStats() const;
+		void ResetCallbackStats() const;
+
+		// Writes the most recent callbacks as a Chrome trace (chrome://tracing or Perfetto),
+		// needs EngineSettings::CallbackTraceCapacity to be set
+		bool WriteCallbackTrace(const std::filesystem::path& path) const;
+
+		uint32_t GetListenerCount() const;
+		const ListenerState& GetListener(uint32_t listenerIndex) const;
+
+		void SetListenerPosition(uint32_t listenerIndex, const Vec3& position) const;
+		void SetListenerDirection(uint32_t listenerIndex, const Vec3& direction) const;
+		void SetListenerVelocity(uint32_t listenerIndex, const Vec3& velocity) const;
+		void SetListenerWorldUp(uint32_t listenerIndex, const Vec3& worldUp) const;
+		void SetListenerCone(uint32_t listenerIndex, const AudioCone& cone) const;
+
+		// Disabled listeners aren't picked as the closest listener and don't hear sounds pinned to them
+		void SetListenerEnabled(uint32_t listenerIndex, bool enabled) const;
+
+		// Moves any number of listeners in one call, meant to be called once per frame,
+		// returns the number of entries that named a valid listener, or that were recorded
+		// when commands are deferred
+		uint32_t UpdateListeners(std::span<const ListenerUpdate> updates) const;
+
+		// The listener an unpinned sound at 'position' is heard by
+		uint32_t FindClosestListener(const Vec3& position) const;
+
+		// Occlusion filters every sound with a low-pass and gain driven by Sound::SetOcclusion. With
+		// a query callback, Context::Update keeps asking the game for line of sight in throttled batches.
+		const OcclusionSettings& GetOcclusionSettings() const;
+		void SetOcclusionSettings(const OcclusionSettings& settings) const;
+
+		// Virtual voices are culled by Context::Update, see VirtualVoiceSettings
+		const VirtualVoiceSettings& GetVirtualVoiceSettings() const;
+		void SetVirtualVoiceSettings(const VirtualVoiceSettings& settings) const;
+		uint32_t GetVirtualVoiceCount() const;
+
+		// When the voice budget is full Sound::Play steals the lowest priority, quietest voice,
+		// or fails if every playing voice has a higher priority than the new one
+		const VoiceLimitSettings& GetVoiceLimitSettings() const;
+		void SetVoiceLimitSettings(const VoiceLimitSettings& settings) const;
+		VoiceStats GetVoiceStats() const;
 
 		inline ID GetID() const { return m_EngineID; }
 
@@ -0,0 +1,147 @@
+#include "Error.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+namespace Wave {
+
+	static thread_local ErrorRecord s_LastError;
+
+	const ErrorRecord& GetLastError()
+	{
+		return s_LastError;
+	}
+
+	void SetLastError(ErrorCode code, ID target, uint64_t value0, uint64_t value1, std::string_view detail)
+	{
+		s_LastError.Code = code;
+		s_LastError.Target = target;
+		s_LastError.Values[0] = value0;
+		s_LastError.Values[1] = value1;
+
+		size_t length = std::min<size_t>(detail.size(), ErrorRecord::MaxDetailLength);
+		std::memcpy(s_LastError.Detail, detail.data(), length);
+		s_LastError.Detail[length] = '\0';
+	}
+
+	void SetLastError(const ErrorRecord& record)
+	{
+		s_LastError = record;
+	}
+
+	void ClearLastError()
+	{
+		s_LastError = ErrorRecord();
+	}
+
+	const char* GetErrorName(ErrorCode code)
+	{
+		switch (code)
+		{
+			case ErrorCode::None:                  return "None";
+			case ErrorCode::InvalidEngine:         return "InvalidEngine";
+			case ErrorCode::InvalidSound:          return "InvalidSound";
+			case ErrorCode::InvalidSoundGroup:     return "InvalidSoundGroup";
+			case ErrorCode::InvalidOneShotPool:    return "InvalidOneShotPool";
+			case ErrorCode::GroupEngineMismatch:   return "GroupEngineMismatch";
+			case ErrorCode::InvalidSettings:       return "InvalidSettings";
+			case ErrorCode::OutOfSlots:            return "OutOfSlots";
+			case ErrorCode::OutOfMemory:           return "OutOfMemory";
+			case ErrorCode::BackendFailed:         return "BackendFailed";
+			case ErrorCode::DeviceIndexOutOfRange: return "DeviceIndexOutOfRange";
+			case ErrorCode::DeviceOpenFailed:      return "DeviceOpenFailed";
+			case ErrorCode::EngineInitFailed:      return "EngineInitFailed";
+			case ErrorCode::SoundGroupInitFailed:  return "SoundGroupInitFailed";
+			case ErrorCode::FileLoadFailed:        return "FileLoadFailed";
+			case ErrorCode::DecodeFailed:          return "DecodeFailed";
+			case ErrorCode::DataSourceFailed:      return "DataSourceFailed";
+			case ErrorCode::BankEntryFailed:       return "BankEntryFailed";
+			case ErrorCode::BankEntryNotFound:     return "BankEntryNotFound";
+			case ErrorCode::SoundInfoFailed:       return "SoundInfoFailed";
+			case ErrorCode::TooLargeForCache:      return "TooLargeForCache";
+			case ErrorCode::NotPreloaded:          return "NotPreloaded";
+			case ErrorCode::SoundPoolExists:       return "SoundPoolExists";
+			case ErrorCode::SoundPoolNotFound:     return "SoundPoolNotFound";
+			case ErrorCode::OneShotVoiceFailed:    return "OneShotVoiceFailed";
+			case ErrorCode::SoundNotLoaded:        return "SoundNotLoaded";
+			case ErrorCode::VoiceLimitReached:     return "VoiceLimitReached";
+			case ErrorCode::StartFailed:           return "StartFailed";
+			case ErrorCode::StopFailed:            return "StopFailed";
+			case ErrorCode::CursorFailed:          return "CursorFailed";
+			case ErrorCode::SeekFailed:            return "SeekFailed";
+			case ErrorCode::OcclusionFilterFailed: return "OcclusionFilterFailed";
+			case ErrorCode::EffectInitFailed:      return "EffectInitFailed";
+			case ErrorCode::EffectNotFound:        return "EffectNotFound";
+			case ErrorCode::EffectUpdateFailed:    return "EffectUpdateFailed";
+			case ErrorCode::EngineOffline:         return "EngineOffline";
+			case ErrorCode::EngineNotOffline:      return "EngineNotOffline";
+			case ErrorCode::RenderFailed:          return "RenderFailed";
+			case ErrorCode::FileWriteFailed:       return "FileWriteFailed";
+			case ErrorCode::TracingDisabled:       return "TracingDisabled";
+			case ErrorCode::NoSequencer:           return "NoSequencer";
+			case ErrorCode::SequencerFull:         return "SequencerFull";
+			case ErrorCode::CommandQueueFull:      return "CommandQueueFull";
+		}
+
+		return "Unknown";
+	}
+
+	std::string FormatError(const ErrorRecord& record)
+	{
+		uint64_t target = uint64_t(record.Target);
+		uint64_t value0 = record.Values[0];
+		uint64_t value1 = record.Values[1];
+		std::string_view detail = record.Detail;
+
+		switch (record.Code)
+		{
+			case ErrorCode::None:                  return "";
+			case ErrorCode::InvalidEngine:         return std::format("Invalid engine ID: '{}'", target);
+			case ErrorCode::InvalidSound:          return std::format("Invalid sound ID: '{}'", target);
+			case ErrorCode::InvalidSoundGroup:     return std::format("Invalid sound group ID: '{}'", target);
+			case ErrorCode::InvalidOneShotPool:    return std::format("Invalid one-shot pool ID: '{}'", target);
+			case ErrorCode::GroupEngineMismatch:   return std::format("Sound group with ID: '{}' belongs to a different engine", target);
+			case ErrorCode::InvalidSettings:       return std::format("Invalid settings: {}", detail);
+			case ErrorCode::OutOfSlots:            return std::format("Exceeded the maximum number of {}", detail);
+			case ErrorCode::OutOfMemory:           return std::format("Out of memory {}", detail);
+			case ErrorCode::BackendFailed:         return std::format("miniaudio failed to {}", detail);
+			case ErrorCode::DeviceIndexOutOfRange: return std::format("Invalid playback device index: '{}', the context found {} playback devices", (int64_t)value0, value1);
+			case ErrorCode::DeviceOpenFailed:      return std::format("Failed to open playback device '{}'{}", detail, value0 != 0 ? " in exclusive mode" : "");
+			case ErrorCode::EngineInitFailed:      return "Failed to create engine";
+			case ErrorCode::SoundGroupInitFailed:  return "Failed to create sound group";
+			case ErrorCode::FileLoadFailed:        return std::format("Failed to create sound from: '{}'", detail);
+			case ErrorCode::DecodeFailed:          return std::format("Failed to decode sound: '{}'", detail);
+			case ErrorCode::DataSourceFailed:      return std::format("Failed to create sound from data source of {} bytes", value0);
+			case ErrorCode::BankEntryFailed:       return std::format("Failed to create sound from sound bank entry with hash: '{}'", value0);
+			case ErrorCode::BankEntryNotFound:     return detail.empty() ? std::format("No sound bank entry with hash: '{}'", value0) : std::format("No sound bank entry named: '{}'", detail);
+			case ErrorCode::SoundInfoFailed:       return std::format("Failed to get length of sound with ID: '{}'", target);
+			case ErrorCode::TooLargeForCache:      return std::format("'{}' doesn't fit the decoded sound cache budget", detail);
+			case ErrorCode::NotPreloaded:          return std::format("Sound was not preloaded: '{}'", detail);
+			case ErrorCode::SoundPoolExists:       return std::format("A sound pool already exists for: '{}'", detail);
+			case ErrorCode::SoundPoolNotFound:     return std::format("No sound pool exists for: '{}'", detail);
+			case ErrorCode::OneShotVoiceFailed:    return std::format("Failed to create one-shot voice {} of {} for '{}'", value0, value1, detail);
+			case ErrorCode::SoundNotLoaded:        return std::format("Sound with ID: '{}' failed to load and can't be played", target);
+			case ErrorCode::VoiceLimitReached:     return std::format("Voice limit reached, sound with ID: '{}' was not started", target);
+			case ErrorCode::StartFailed:           return std::format("Failed to start {} with ID: '{}'", detail, target);
+			case ErrorCode::StopFailed:            return std::format("Failed to stop {} with ID: '{}'", detail, target);
+			case ErrorCode::CursorFailed:          return std::format("Failed to get cursor of sound with ID: '{}'", target);
+			case ErrorCode::SeekFailed:            return std::format("Failed to seek to frame '{}' on sound with ID: '{}'", value0, target);
+			case ErrorCode::OcclusionFilterFailed: return std::format("Failed to create the occlusion filter of sound with ID: '{}'", target);
+			case ErrorCode::EffectInitFailed:      return std::format("Failed to add effect to sound group with ID: '{}'", target);
+			case ErrorCode::EffectNotFound:        return std::format("Sound group with ID: '{}' has no effect of that type at index {}", target, value0);
+			case ErrorCode::EffectUpdateFailed:    return std::format("Failed to update effect {} of sound group with ID: '{}'", value0, target);
+			case ErrorCode::EngineOffline:         return std::format("Engine with ID: '{}' is offline, it's driven by Render instead", target);
+			case ErrorCode::EngineNotOffline:      return std::format("Engine with ID: '{}' is driven by its device, only offline engines can render", target);
+			case ErrorCode::RenderFailed:          return detail.empty() ? std::format("Failed to render engine with ID: '{}'", target) : std::format("Failed to render engine with ID: '{}' to '{}'", target, detail);
+			case ErrorCode::FileWriteFailed:       return std::format("Failed to open '{}' for writing", detail);
+			case ErrorCode::TracingDisabled:       return "Callback tracing is disabled, set EngineSettings::CallbackTraceCapacity";
+			case ErrorCode::NoSequencer:           return std::format("Engine with ID: '{}' was created without a sequencer", target);
+			case ErrorCode::SequencerFull:         return std::format("Sequencer of engine with ID: '{}' is full", target);
+			case ErrorCode::CommandQueueFull:      return std::format("Command queue is full, dropped a call on ID: '{}'", target);
+		}
+
+		return std::format("Unknown error: {}", (uint32_t)record.Code);
+	}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Wave/ID.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Wave {
+
+	enum class ErrorCode : uint32_t
+	{
+		None = 0,
+
+		// Handles and arguments
+		InvalidEngine,
+		InvalidSound,
+		InvalidSoundGroup,
+		InvalidOneShotPool,
+		GroupEngineMismatch,
+		InvalidSettings,
+		OutOfSlots,
+		OutOfMemory,
+
+		// Context and devices
+		BackendFailed,
+		DeviceIndexOutOfRange,
+		DeviceOpenFailed,
+		EngineInitFailed,
+		SoundGroupInitFailed,
+
+		// Creating sounds
+		FileLoadFailed,
+		DecodeFailed,
+		DataSourceFailed,
+		BankEntryFailed,
+		BankEntryNotFound,
+		SoundInfoFailed,
+		TooLargeForCache,
+		NotPreloaded,
+		SoundPoolExists,
+		SoundPoolNotFound,
+		OneShotVoiceFailed,
+
+		// Playback
+		SoundNotLoaded,
+		VoiceLimitReached,
+		StartFailed,
+		StopFailed,
+		CursorFailed,
+		SeekFailed,
+		OcclusionFilterFailed,
+		EffectInitFailed,
+		EffectNotFound,
+		EffectUpdateFailed,
+
+		// Engines
+		EngineOffline,
+		EngineNotOffline,
+		RenderFailed,
+		FileWriteFailed,
+		TracingDisabled,
+		NoSequencer,
+		SequencerFull,
+		CommandQueueFull,
+	};
+
+	/* The last failure on a thread. Filled in without allocating, the message is only built
+	   by FormatError when someone asks for it. What Values and Detail hold depends on the code. */
+	struct ErrorRecord
+	{
+		inline static constexpr uint32_t MaxDetailLength = 255;
+
+		ErrorCode Code = ErrorCode::None;
+		ID Target = ID::Invalid;           /* Handle the failed call was made on, if any. */
+		uint64_t Values[2] = {};           /* E.g. the frame a seek asked for. */
+		char Detail[MaxDetailLength + 1] = {}; /* E.g. the path that failed to load, truncated to fit. */
+	};
+
+	// Thread local, so an error storm on one thread never touches another thread's record or the heap
+	const ErrorRecord& GetLastError();
+	void SetLastError(ErrorCode code, ID target = ID::Invalid, uint64_t value0 = 0, uint64_t value1 = 0, std::string_view detail = {});
+	// Hands a record over from another thread, e.g. a failed asynchronous load
+	void SetLastError(const ErrorRecord& record);
+	void ClearLastError();
+
+	const char* GetErrorName(ErrorCode code);
+	std::string FormatError(const ErrorRecord& record);
+
+}
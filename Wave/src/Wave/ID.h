@@ -10,10 +10,23 @@ namespace Wave {
 	public:
 		inline static constexpr uint64_t Invalid = 18274635174627364826Ui64;
 
+		// Layout is { generation:32, context:8, index:24 }
+		inline static constexpr uint32_t IndexBits = 24;
+		inline static constexpr uint32_t MaxContexts = 256;
+
 	public:
 		inline ID(uint64_t id) : m_ID(id) { }
+		inline ID(uint32_t index, uint32_t generation, uint32_t contextIndex = 0)
+			: m_ID(((uint64_t)generation << 32) | ((uint64_t)contextIndex << IndexBits) | index) { }
 		~ID() = default;
 
+		// Slot in the owning handle table
+		inline uint32_t GetIndex() const { return (uint32_t)(m_ID & ((1u << IndexBits) - 1)); }
+		// Context that handed the handle out, so calls on it reach that context's state
+		inline uint32_t GetContextIndex() const { return (uint32_t)((m_ID >> IndexBits) & (MaxContexts - 1)); }
+		// Incremented each time a slot is reused so stale handles can be detected
+		inline uint32_t GetGeneration() const { return (uint32_t)(m_ID >> 32); }
+
 		inline operator uint64_t() const { return m_ID; }
 
 	private:
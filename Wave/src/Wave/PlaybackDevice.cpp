@@ -23,8 +23,19 @@ namespace Wave {
 
 	bool PlaybackDevice::Init(std::shared_ptr<Context> context, const DataSource& src)
 	{
-		WAVE_ASSERT(false, "Not implemented yet!%s", "");
-		return false;
+		m_Engine = context->CreateEngine();
+		if (m_Engine.GetID() == ID::Invalid)
+		{
+			return false;
+		}
+
+		m_Sound = context->CreateSoundFromDataSource(m_Engine, src.Data, src.Length);
+		if (m_Sound.GetID() == ID::Invalid)
+		{
+			return false;
+		}
+
+		return true;
 	}
 
 	bool PlaybackDevice::Shutdown(std::shared_ptr<Context> context)
@@ -0,0 +1,86 @@
+#include "Sequencer.h"
+
+#include "Wave/Assert.h"
+
+#include <algorithm>
+
+namespace Wave {
+
+	Sequencer::Sequencer(uint32_t capacity, Allocator* allocator)
+		: m_Heap(StlAllocator<Entry>(allocator)), m_Capacity(capacity)
+	{
+		WAVE_ASSERT(capacity > 0, "Sequencer capacity must not be zero!%s", "");
+
+		m_Inbox.Init(capacity, allocator);
+		m_Fired.Init(capacity, allocator);
+		m_Heap.reserve(capacity);
+	}
+
+	bool Sequencer::Push(const SequencerEvent& event)
+	{
+		// Events travel through the inbox packed like any other command
+		Command command = MakeCommand(CommandType::None, event.SoundID, { event.Value, event.FadeFrom }, { event.TimeInPCMFrames, event.FadeLengthInPCMFrames });
+		command.Flags = (uint32_t)event.Type;
+
+		return m_Inbox.Push(command);
+	}
+
+	void Sequencer::Collect()
+	{
+		Command command;
+
+		if (m_ClearRequested.exchange(false, std::memory_order_acquire))
+		{
+			m_Heap.clear();
+
+			while (m_Inbox.Pop(command))
+			{
+			}
+		}
+
+		// Whatever doesn't fit stays in the inbox until earlier events make room
+		while (m_Heap.size() < m_Capacity && m_Inbox.Pop(command))
+		{
+			Entry& entry = m_Heap.emplace_back();
+			entry.Event.Type = (SequencerEventType)command.Flags;
+			entry.Event.SoundID = command.Target;
+			entry.Event.TimeInPCMFrames = command.Integers[0];
+			entry.Event.FadeLengthInPCMFrames = command.Integers[1];
+			entry.Event.Value = command.Floats[0];
+			entry.Event.FadeFrom = command.Floats[1];
+			entry.Order = m_NextOrder++;
+
+			std::push_heap(m_Heap.begin(), m_Heap.end(), Later);
+		}
+
+		m_Pending.store((uint32_t)m_Heap.size(), std::memory_order_relaxed);
+	}
+
+	bool Sequencer::PopDue(uint64_t time, SequencerEvent& event)
+	{
+		if (m_Heap.empty() || m_Heap.front().Event.TimeInPCMFrames > time)
+		{
+			return false;
+		}
+
+		std::pop_heap(m_Heap.begin(), m_Heap.end(), Later);
+		event = m_Heap.back().Event;
+		m_Heap.pop_back();
+
+		m_Pending.store((uint32_t)m_Heap.size(), std::memory_order_relaxed);
+		m_FiredCount.store(m_FiredCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	SequencerStats Sequencer::GetStats() const
+	{
+		SequencerStats stats;
+		stats.Pending = m_Pending.load(std::memory_order_relaxed);
+		stats.Fired = m_FiredCount.load(std::memory_order_relaxed);
+		stats.Dropped = m_Inbox.GetDroppedCount();
+
+		return stats;
+	}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Wave/Engine.h"
+#include "Wave/CommandQueue.h"
+#include "Wave/Allocator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Wave {
+
+	// Holds an engine's scheduled events until the audio thread reaches their time. Any thread
+	// pushes into a lock-free inbox, the audio thread moves them into a min-heap keyed on time
+	// (ties keep their push order) and pops them as the mix gets to them. The heap is sized
+	// up front, so the audio thread never allocates.
+	class Sequencer
+	{
+	public:
+		Sequencer(uint32_t capacity, Allocator* allocator);
+		~Sequencer() = default;
+
+		Sequencer(const Sequencer&) = delete;
+		Sequencer& operator=(const Sequencer&) = delete;
+
+		// Any thread, false when the inbox is full
+		bool Push(const SequencerEvent& event);
+
+		// Applied by the audio thread on its next callback
+		inline void Clear() { m_ClearRequested.store(true, std::memory_order_release); }
+
+		// Audio thread only. Moves newly pushed events into the heap, as many as fit.
+		void Collect();
+		// Audio thread only. Pops the earliest event if it's due at 'time'.
+		bool PopDue(uint64_t time, SequencerEvent& event);
+		// Audio thread only, UINT64_MAX when nothing is scheduled
+		inline uint64_t GetNextTime() const { return m_Heap.empty() ? UINT64_MAX : m_Heap.front().Event.TimeInPCMFrames; }
+
+		// Play, stop and parameter events the audio thread applied, for Context::Update to
+		// mirror into the state it keeps on the context thread. Single producer, single consumer.
+		inline CommandQueue& GetFired() { return m_Fired; }
+
+		// Held by the audio thread while it applies events and by the context thread while it
+		// tears a sound down. The audio thread only ever tries it, if it's taken the events
+		// wait for the next period instead of blocking the mix.
+		inline std::mutex& GetApplyMutex() { return m_ApplyMutex; }
+
+		SequencerStats GetStats() const;
+
+		// False when the queues couldn't be allocated
+		inline bool IsInitialized() const { return m_Inbox.IsInitialized() && m_Fired.IsInitialized(); }
+
+	private:
+		struct Entry
+		{
+			SequencerEvent Event;
+			uint64_t Order = 0;
+		};
+
+		// Min-heap on time, then push order
+		inline static bool Later(const Entry& a, const Entry& b)
+		{
+			return a.Event.TimeInPCMFrames != b.Event.TimeInPCMFrames ? a.Event.TimeInPCMFrames > b.Event.TimeInPCMFrames : a.Order > b.Order;
+		}
+
+	private:
+		CommandQueue m_Inbox;
+		CommandQueue m_Fired;
+		std::mutex m_ApplyMutex;
+
+		// Audio thread only
+		std::vector<Entry, StlAllocator<Entry>> m_Heap;
+		uint32_t m_Capacity = 0;
+		uint64_t m_NextOrder = 0;
+
+		std::atomic<bool> m_ClearRequested = false;
+		std::atomic<uint32_t> m_Pending = 0;
+		std::atomic<uint64_t> m_FiredCount = 0;
+	};
+
+}
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "Wave/ID.h"
+#include "Wave/Allocator.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace Wave {
+
+	// Generational handle table. Elements live in fixed-size pages that are never moved,
+	// so miniaudio objects embedded in T keep their address for as long as they are alive.
+	// A handle is only resolved when both its index and generation match the slot.
+	//
+	// Insert and Remove are lock-free: released slots are pushed onto a tagged Treiber stack
+	// and popped again by the next Insert, and new pages are published into a fixed page table
+	// with a CAS. Any number of threads may allocate and release handles concurrently, but the
+	// contents of T are owned by whoever holds the handle.
+	template <typename T, uint32_t PageSize = 256, uint32_t MaxPages = 4096>
+	class SlotMap
+	{
+		static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two!");
+		static_assert((uint64_t)PageSize * MaxPages <= (1ull << ID::IndexBits), "Slot indices must fit the handle's index bits!");
+
+	public:
+		inline static constexpr uint32_t MaxSlots = PageSize * MaxPages;
+
+	public:
+		SlotMap() = default;
+
+		~SlotMap()
+		{
+			for (uint32_t i = 0; i < MaxPages; i++)
+			{
+				m_Allocator->DeleteArray(m_Pages[i].load(std::memory_order_relaxed), PageSize);
+			}
+		}
+
+		SlotMap(const SlotMap&) = delete;
+		SlotMap& operator=(const SlotMap&) = delete;
+
+		// Stamped into every handle handed out, handles from other contexts never resolve
+		inline void SetContextIndex(uint32_t contextIndex) { m_ContextIndex = contextIndex; }
+		// Pages are allocated through this from then on, must be set before the first insert
+		inline void SetAllocator(Allocator* allocator) { m_Allocator = allocator; }
+
+		// Returns ID::Invalid when every slot is in use
+		ID Insert()
+		{
+			uint32_t index = PopFreeSlot();
+
+			if (index == EmptyIndex)
+			{
+				index = m_Capacity.fetch_add(1, std::memory_order_relaxed);
+
+				if (index >= MaxSlots || !EnsurePage(index / PageSize))
+				{
+					m_Capacity.fetch_sub(1, std::memory_order_relaxed);
+					return ID::Invalid;
+				}
+			}
+
+			Slot& slot = GetSlot(index);
+			slot.Value = T();
+			slot.Occupied.store(true, std::memory_order_release);
+			m_Size.fetch_add(1, std::memory_order_relaxed);
+
+			return ID(index, slot.Generation.load(std::memory_order_relaxed), m_ContextIndex);
+		}
+
+		bool Remove(ID id)
+		{
+			if (!Contains(id))
+			{
+				return false;
+			}
+
+			uint32_t index = id.GetIndex();
+			Slot& slot = GetSlot(index);
+
+			bool expected = true;
+			if (!slot.Occupied.compare_exchange_strong(expected, false, std::memory_order_acq_rel))
+			{
+				return false;
+			}
+
+			// Bump the generation so every outstanding handle to this slot goes stale
+			slot.Generation.store(NextGeneration(slot.Generation.load(std::memory_order_relaxed)), std::memory_order_release);
+			m_Size.fetch_sub(1, std::memory_order_relaxed);
+			PushFreeSlot(index);
+
+			return true;
+		}
+
+		// Makes every outstanding handle to a live slot go stale and returns a new one for it,
+		// the value stays as it is. Used to hand a slot over without freeing it.
+		ID Reissue(ID id)
+		{
+			if (!Contains(id))
+			{
+				return ID::Invalid;
+			}
+
+			Slot& slot = GetSlot(id.GetIndex());
+			uint32_t generation = NextGeneration(slot.Generation.load(std::memory_order_relaxed));
+			slot.Generation.store(generation, std::memory_order_release);
+
+			return ID(id.GetIndex(), generation, m_ContextIndex);
+		}
+
+		inline bool Contains(ID id) const
+		{
+			uint32_t index = id.GetIndex();
+
+			if (index >= MaxSlots || id.GetContextIndex() != m_ContextIndex)
+			{
+				return false;
+			}
+
+			const Slot* page = m_Pages[index / PageSize].load(std::memory_order_acquire);
+
+			if (page == nullptr)
+			{
+				return false;
+			}
+
+			const Slot& slot = page[index & (PageSize - 1)];
+			return slot.Occupied.load(std::memory_order_acquire) && slot.Generation.load(std::memory_order_acquire) == id.GetGeneration();
+		}
+
+		inline T* Get(ID id)
+		{
+			return Contains(id) ? &GetSlot(id.GetIndex()).Value : nullptr;
+		}
+
+		inline const T* Get(ID id) const
+		{
+			return Contains(id) ? &GetSlot(id.GetIndex()).Value : nullptr;
+		}
+
+		// Resolves a raw slot index without a generation check, for passes that walk every slot
+		inline T* GetByIndex(uint32_t index)
+		{
+			if (index >= MaxSlots)
+			{
+				return nullptr;
+			}
+
+			Slot* page = m_Pages[index / PageSize].load(std::memory_order_acquire);
+
+			if (page == nullptr || !page[index & (PageSize - 1)].Occupied.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+
+			return &page[index & (PageSize - 1)].Value;
+		}
+
+		// The handle of whatever currently occupies a raw slot index, ID::Invalid for free slots
+		inline ID GetIDByIndex(uint32_t index) const
+		{
+			if (index >= MaxSlots)
+			{
+				return ID::Invalid;
+			}
+
+			const Slot* page = m_Pages[index / PageSize].load(std::memory_order_acquire);
+
+			if (page == nullptr || !page[index & (PageSize - 1)].Occupied.load(std::memory_order_acquire))
+			{
+				return ID::Invalid;
+			}
+
+			return ID(index, page[index & (PageSize - 1)].Generation.load(std::memory_order_acquire), m_ContextIndex);
+		}
+
+		// Allocates pages up front so the first 'count' inserts never touch the heap
+		bool Reserve(uint32_t count)
+		{
+			if (count > MaxSlots)
+			{
+				return false;
+			}
+
+			for (uint32_t page = 0; page * PageSize < count; page++)
+			{
+				if (!EnsurePage(page))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		inline uint32_t Size() const { return m_Size.load(std::memory_order_relaxed); }
+		inline uint32_t Capacity() const { return m_Capacity.load(std::memory_order_relaxed); }
+
+	private:
+		inline static constexpr uint32_t EmptyIndex = 0xFFFFFFFF;
+
+		struct Slot
+		{
+			T Value;
+			std::atomic<uint32_t> Generation = 1;
+			std::atomic<uint32_t> NextFree = EmptyIndex;
+			std::atomic<bool> Occupied = false;
+		};
+
+		inline Slot& GetSlot(uint32_t index) { return m_Pages[index / PageSize].load(std::memory_order_acquire)[index & (PageSize - 1)]; }
+		inline const Slot& GetSlot(uint32_t index) const { return m_Pages[index / PageSize].load(std::memory_order_acquire)[index & (PageSize - 1)]; }
+
+		bool EnsurePage(uint32_t pageIndex)
+		{
+			if (m_Pages[pageIndex].load(std::memory_order_acquire) != nullptr)
+			{
+				return true;
+			}
+
+			Slot* page = m_Allocator->NewArray<Slot>(PageSize);
+
+			if (page == nullptr)
+			{
+				return false;
+			}
+
+			Slot* expected = nullptr;
+
+			// Another thread may have published this page first, in which case ours is discarded
+			if (!m_Pages[pageIndex].compare_exchange_strong(expected, page, std::memory_order_acq_rel))
+			{
+				m_Allocator->DeleteArray(page, PageSize);
+			}
+
+			return true;
+		}
+
+		// The free list head packs { tag:32, index:32 }, the tag is bumped on every
+		// successful exchange so a pop can't be fooled by a slot that was recycled (ABA)
+		inline static uint64_t PackHead(uint32_t index, uint32_t tag) { return ((uint64_t)tag << 32) | index; }
+		inline static uint32_t HeadIndex(uint64_t head) { return (uint32_t)(head & 0xFFFFFFFF); }
+		inline static uint32_t HeadTag(uint64_t head) { return (uint32_t)(head >> 32); }
+
+		uint32_t PopFreeSlot()
+		{
+			uint64_t head = m_FreeHead.load(std::memory_order_acquire);
+
+			while (HeadIndex(head) != EmptyIndex)
+			{
+				uint32_t next = GetSlot(HeadIndex(head)).NextFree.load(std::memory_order_relaxed);
+
+				if (m_FreeHead.compare_exchange_weak(head, PackHead(next, HeadTag(head) + 1), std::memory_order_acq_rel, std::memory_order_acquire))
+				{
+					return HeadIndex(head);
+				}
+			}
+
+			return EmptyIndex;
+		}
+
+		void PushFreeSlot(uint32_t index)
+		{
+			Slot& slot = GetSlot(index);
+			uint64_t head = m_FreeHead.load(std::memory_order_relaxed);
+
+			do
+			{
+				slot.NextFree.store(HeadIndex(head), std::memory_order_relaxed);
+			}
+			while (!m_FreeHead.compare_exchange_weak(head, PackHead(index, HeadTag(head) + 1), std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		inline static uint32_t NextGeneration(uint32_t generation)
+		{
+			// Generation 0 is never handed out so a zeroed handle can't resolve
+			return generation + 1 == 0 ? 1 : generation + 1;
+		}
+
+	private:
+		std::atomic<Slot*> m_Pages[MaxPages] = {};
+		std::atomic<uint64_t> m_FreeHead = PackHead(EmptyIndex, 0);
+		std::atomic<uint32_t> m_Capacity = 0;
+		std::atomic<uint32_t> m_Size = 0;
+		uint32_t m_ContextIndex = 0;
+		Allocator* m_Allocator = &Allocator::GetDefault();
+	};
+
+}
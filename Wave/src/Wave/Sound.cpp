@@ -1,36 +1,97 @@
 #include "Sound.h"
 
 #include "Wave/Context.h"
+#include "Wave/SoundSpatialStore.h"
+#include "Wave/CommandQueue.h"
 #include "Wave/Assert.h"
 #include "Wave/Utils.h"
 
 #include <miniaudio/miniaudio.h>
 
-#include <format>
-
 namespace Wave {
 
+	namespace Utils {
+
+		// Handed out by the getters returning references when the handle is stale
+		static const AudioCone s_InvalidCone = AudioCone();
+
+	}
+
 	bool Sound::Play() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundPlay, m_SoundID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return false;
+		}
+
+		if (data->LoadState == SoundLoadState::Loading)
+		{
+			// Context::Update starts it once the loader is done
+			data->PlayPending = true;
+			return true;
+		}
+
+		if (data->LoadState == SoundLoadState::Failed)
+		{
+			SetLastError(ErrorCode::SoundNotLoaded, m_SoundID);
+			return false;
+		}
 
-		ma_result res = ma_sound_start(sound);
+		SoundSpatialStore* store = Context::GetSoundSpatialStore(m_SoundID);
+
+		// A virtual voice is still playing as far as the caller is concerned
+		if (store->HasFlag(m_SoundID.GetIndex(), SpatialFlag_Virtual))
+		{
+			return true;
+		}
+
+		if (!ma_sound_is_playing((ma_sound*)sound) && !Context::AcquireVoice(m_SoundID))
+		{
+			SetLastError(ErrorCode::VoiceLimitReached, m_SoundID);
+			return false;
+		}
+
+		if (data->WasStolen)
+		{
+			// Undo the fade out and stop time left behind by the steal
+			ma_sound_set_stop_time_in_pcm_frames((ma_sound*)sound, ~(ma_uint64)0);
+			ma_sound_set_fade_in_pcm_frames((ma_sound*)sound, 1.0f, 1.0f, 0);
+			data->WasStolen = false;
+		}
+
+		ma_result res = ma_sound_start((ma_sound*)sound);
 
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to start sound with ID: '{}'", uint64_t(m_SoundID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::StartFailed, m_SoundID, 0, 0, "sound");
 			return false;
 		}
 
-		Context::GetSoundInternalData(m_SoundID)->IsPaused = false;
+		data->IsPaused = false;
+		data->PausedByGroup = false;
+		store->SetFlag(m_SoundID.GetIndex(), SpatialFlag_Playing, true);
 
 		return true;
 	}
 
 	bool Sound::Restart() const
 	{
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundRestart, m_SoundID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		SoundData* data = Context::GetSoundInternalData(m_SoundID);
+
+		if (data == nullptr)
+		{
+			return false;
+		}
+
 		if (!IsPlaying())
 		{
 			return true;
@@ -38,401 +99,631 @@ namespace Wave {
 
 		SeekToPCMFrame(0);
 
-		Context::GetSoundInternalData(m_SoundID)->IsPaused = false;
+		data->IsPaused = false;
 
 		return true;
 	}
 
 	bool Sound::Pause() const
 	{
-		if (IsPaused())
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundPause, m_SoundID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return false;
+		}
+
+		if (data->IsPaused)
 		{
 			return true;
 		}
 
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		data->PausedByGroup = false;
+
+		if (data->LoadState != SoundLoadState::Loaded)
+		{
+			data->PlayPending = false;
+			return true;
+		}
 
-		ma_result res = ma_sound_stop(sound);
+		SoundSpatialStore* store = Context::GetSoundSpatialStore(m_SoundID);
 
-		if (res != MA_SUCCESS)
+		if (store->HasFlag(m_SoundID.GetIndex(), SpatialFlag_Virtual))
 		{
-			std::string err = std::format("Failed to stop sound with ID: '{}'", uint64_t(m_SoundID));
-			Context::SetErrorMsg(err);
-			return false;
+			// Already silent, just move the cursor to where it would have been
+			Context::DevirtualizeSound(m_SoundID, false);
 		}
+		else
+		{
+			ma_result res = ma_sound_stop((ma_sound*)sound);
 
-		Context::GetSoundInternalData(m_SoundID)->IsPaused = true;
+			if (res != MA_SUCCESS)
+			{
+				SetLastError(ErrorCode::StopFailed, m_SoundID, 0, 0, "sound");
+				return false;
+			}
+		}
+
+		data->IsPaused = true;
+		store->SetFlag(m_SoundID.GetIndex(), SpatialFlag_Playing, false);
 		
 		return true;
 	}
 
 	bool Sound::Stop() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundStop, m_SoundID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return false;
+		}
+
+		if (data->LoadState != SoundLoadState::Loaded)
+		{
+			data->PlayPending = false;
+			return true;
+		}
 		
-		ma_result res = ma_sound_stop(sound);
+		ma_result res = ma_sound_stop((ma_sound*)sound);
 
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to stop sound with ID: '{}'", uint64_t(m_SoundID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::StopFailed, m_SoundID, 0, 0, "sound");
 			return false;
 		}
 
+		SoundSpatialStore* store = Context::GetSoundSpatialStore(m_SoundID);
+		store->SetFlag(m_SoundID.GetIndex(), SpatialFlag_Virtual, false);
+		store->SetFlag(m_SoundID.GetIndex(), SpatialFlag_Playing, false);
+
 		SeekToPCMFrame(0);
 
-		Context::GetSoundInternalData(m_SoundID)->IsPaused = false;
+		data->IsPaused = false;
 		
 		return true;
 	}
 
 	float Sound::GetVolume() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return 0.0f;
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->Volume;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetVolume(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetVolume(float volume) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetVolume, m_SoundID, { volume })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_volume(sound, volume);
-		Context::GetSoundInternalData(m_SoundID)->Volume = volume;
+		ma_sound_set_volume((ma_sound*)sound, volume);
+		Context::GetSoundSpatialStore(m_SoundID)->SetVolume(m_SoundID.GetIndex(), volume);
 	}
 
 	float Sound::GetPitch() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->Pitch;
+		return data != nullptr ? data->Pitch : 0.0f;
 	}
 
 	void Sound::SetPitch(float pitch) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetPitch, m_SoundID, { pitch })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_pitch(sound, pitch);
-		Context::GetSoundInternalData(m_SoundID)->Pitch = pitch;
+		ma_sound_set_pitch((ma_sound*)sound, pitch);
+		data->Pitch = pitch;
 	}
 
 	float Sound::GetDopplerFactor() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->DopplerFactor;
+		return data != nullptr ? data->DopplerFactor : 0.0f;
 	}
 
 	void Sound::SetDopplerFactor(float dopplerFactor) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetDopplerFactor, m_SoundID, { dopplerFactor })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_doppler_factor(sound, dopplerFactor);
-		Context::GetSoundInternalData(m_SoundID)->DopplerFactor = dopplerFactor;
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_doppler_factor((ma_sound*)sound, dopplerFactor);
+		data->DopplerFactor = dopplerFactor;
 	}
 
-	const Vec3& Sound::GetPosition() const
+	Vec3 Sound::GetPosition() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return Vec3(0.0f);
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->Position;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetPosition(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetPosition(const Vec3& position) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetPosition, m_SoundID, { position.X, position.Y, position.Z })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_position(sound, position.X, position.Y, position.Z);
-		Context::GetSoundInternalData(m_SoundID)->Position = position;
+		ma_sound_set_position((ma_sound*)sound, position.X, position.Y, position.Z);
+		Context::GetSoundSpatialStore(m_SoundID)->SetPosition(m_SoundID.GetIndex(), position.X, position.Y, position.Z);
 	}
 
-	const Vec3& Sound::GetDirection() const
+	Vec3 Sound::GetDirection() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return Vec3(0.0f);
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->Direction;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetDirection(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetDirection(const Vec3& direction) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetDirection, m_SoundID, { direction.X, direction.Y, direction.Z })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_direction(sound, direction.X, direction.Y, direction.Z);
-		Context::GetSoundInternalData(m_SoundID)->Direction = direction;
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_direction((ma_sound*)sound, direction.X, direction.Y, direction.Z);
+		Context::GetSoundSpatialStore(m_SoundID)->SetDirection(m_SoundID.GetIndex(), direction.X, direction.Y, direction.Z);
 	}
 
-	const Vec3& Sound::GetVelocity() const
+	Vec3 Sound::GetVelocity() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return Vec3(0.0f);
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->Velocity;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetVelocity(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetVelocity(const Vec3& velocity) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetVelocity, m_SoundID, { velocity.X, velocity.Y, velocity.Z })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_velocity(sound, velocity.X, velocity.Y, velocity.Z);
-		Context::GetSoundInternalData(m_SoundID)->Velocity = velocity;
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_velocity((ma_sound*)sound, velocity.X, velocity.Y, velocity.Z);
+		Context::GetSoundSpatialStore(m_SoundID)->SetVelocity(m_SoundID.GetIndex(), velocity.X, velocity.Y, velocity.Z);
 	}
 
-	const Vec3& Sound::GetDirectionToListener() const
+	Vec3 Sound::GetDirectionToListener() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
-		
-		ma_vec3f dir = ma_sound_get_direction_to_listener(sound);
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data) || sound == nullptr)
+		{
+			return Vec3(0.0f);
+		}
+
+		ma_vec3f dir = ma_sound_get_direction_to_listener((ma_sound*)sound);
 		return Vec3(dir.x, dir.y, dir.z);
 	}
 
 	const AudioCone& Sound::GetAudioCone() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->Cone;
+		return data != nullptr ? data->Cone : Utils::s_InvalidCone;
 	}
 
 	void Sound::SetAudioCone(const AudioCone& cone) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetAudioCone, m_SoundID, { cone.InnerAngle, cone.OuterAngle, cone.OuterGain })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_cone(sound, Utils::DegreesToRadians(cone.InnerAngle), Utils::DegreesToRadians(cone.OuterAngle), cone.OuterGain);
-		AudioCone& cone_ = Context::GetSoundInternalData(m_SoundID)->Cone;
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_cone((ma_sound*)sound, Utils::DegreesToRadians(cone.InnerAngle), Utils::DegreesToRadians(cone.OuterAngle), cone.OuterGain);
+		AudioCone& cone_ = data->Cone;
 		cone_.InnerAngle = Utils::DegreesToRadians(cone.InnerAngle);
 		cone_.OuterAngle = Utils::DegreesToRadians(cone.OuterAngle);
 		cone_.OuterGain = cone.OuterGain;
+		Context::GetSoundSpatialStore(m_SoundID)->SetCone(m_SoundID.GetIndex(), cone_);
 	}
 
 	float Sound::GetMinGain() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return 0.0f;
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->MinGain;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetMinGain(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetMinGain(float minGain) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetMinGain, m_SoundID, { minGain })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_min_gain(sound, minGain);
-		Context::GetSoundInternalData(m_SoundID)->MinGain = minGain;
+		ma_sound_set_min_gain((ma_sound*)sound, minGain);
+		Context::GetSoundSpatialStore(m_SoundID)->SetMinGain(m_SoundID.GetIndex(), minGain);
 	}
 
 	float Sound::GetMaxGain() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return 0.0f;
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->MaxGain;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetMaxGain(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetMaxGain(float maxGain) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetMaxGain, m_SoundID, { maxGain })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_max_gain(sound, maxGain);
-		Context::GetSoundInternalData(m_SoundID)->MaxGain = maxGain;
+		ma_sound_set_max_gain((ma_sound*)sound, maxGain);
+		Context::GetSoundSpatialStore(m_SoundID)->SetMaxGain(m_SoundID.GetIndex(), maxGain);
 	}
 
 	float Sound::GetFalloff() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return 0.0f;
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->Falloff;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetRolloff(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetFalloff(float falloff) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetFalloff, m_SoundID, { falloff })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_rolloff(sound, falloff);
-		Context::GetSoundInternalData(m_SoundID)->Falloff = falloff;
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_rolloff((ma_sound*)sound, falloff);
+		Context::GetSoundSpatialStore(m_SoundID)->SetRolloff(m_SoundID.GetIndex(), falloff);
 	}
 
 	float Sound::GetMinDistance() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return 0.0f;
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->MinDistance;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetMinDistance(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetMinDistance(float minDistance) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetMinDistance, m_SoundID, { minDistance })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_min_distance(sound, minDistance);
-		Context::GetSoundInternalData(m_SoundID)->MinDistance = minDistance;
+		ma_sound_set_min_distance((ma_sound*)sound, minDistance);
+		Context::GetSoundSpatialStore(m_SoundID)->SetMinDistance(m_SoundID.GetIndex(), minDistance);
 	}
 
 	float Sound::GetMaxDistance() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::GetSoundInternalData(m_SoundID) == nullptr)
+		{
+			return 0.0f;
+		}
 
-		return Context::GetSoundInternalData(m_SoundID)->MaxDistance;
+		return Context::GetSoundSpatialStore(m_SoundID)->GetMaxDistance(m_SoundID.GetIndex());
 	}
 
 	void Sound::SetMaxDistance(float maxDistance) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetMaxDistance, m_SoundID, { maxDistance })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
 
-		ma_sound_set_max_distance(sound, maxDistance);
-		Context::GetSoundInternalData(m_SoundID)->MaxDistance = maxDistance;
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_max_distance((ma_sound*)sound, maxDistance);
+		Context::GetSoundSpatialStore(m_SoundID)->SetMaxDistance(m_SoundID.GetIndex(), maxDistance);
 	}
 
 	AttenuationModel Sound::GetAttenuationModel() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->Model;
+		return data != nullptr ? data->Model : AttenuationModel::None;
 	}
 
 	void Sound::SetAttenuationModel(AttenuationModel model) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetAttenuationModel, m_SoundID, {}, { (uint64_t)model })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_attenuation_model(sound, (ma_attenuation_model)model);
-		Context::GetSoundInternalData(m_SoundID)->Model = model;
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_attenuation_model((ma_sound*)sound, (ma_attenuation_model)model);
+		data->Model = model;
+		Context::GetSoundSpatialStore(m_SoundID)->SetModel(m_SoundID.GetIndex(), model);
 	}
 
 	float Sound::GetDirectionalAttenuationFactor() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->DirectionalAttenuationFactor;
+		return data != nullptr ? data->DirectionalAttenuationFactor : 0.0f;
 	}
 
 	void Sound::SetDirectionalAttenuationFactor(float factor) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetDirectionalAttenuationFactor, m_SoundID, { factor })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 		
-		ma_sound_set_directional_attenuation_factor(sound, factor);
-		Context::GetSoundInternalData(m_SoundID)->MaxDistance = factor;
+		ma_sound_set_directional_attenuation_factor((ma_sound*)sound, factor);
+		data->DirectionalAttenuationFactor = factor;
 	}
 
 	float Sound::GetPan() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 		
-		return Context::GetSoundInternalData(m_SoundID)->Pan;
+		return data != nullptr ? data->Pan : 0.0f;
 	}
 
 	void Sound::SetPan(float pan) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetPan, m_SoundID, { pan })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
 
-		ma_sound_set_pan(sound, pan);
-		Context::GetSoundInternalData(m_SoundID)->Pan = pan;
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_pan((ma_sound*)sound, pan);
+		data->Pan = pan;
 	}
 
 	PanMode Sound::GetPanMode() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->PanMode;
+		return data != nullptr ? data->PanMode : PanMode::Balance;
 	}
 
 	void Sound::SetPanMode(PanMode panMode) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetPanMode, m_SoundID, {}, { (uint64_t)panMode })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 		
-		ma_sound_set_pan_mode(sound, (ma_pan_mode)panMode);
-		Context::GetSoundInternalData(m_SoundID)->PanMode = panMode;
+		ma_sound_set_pan_mode((ma_sound*)sound, (ma_pan_mode)panMode);
+		data->PanMode = panMode;
 	}
 
 	Positioning Sound::GetPositioning() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->Positioning_;
+		return data != nullptr ? data->Positioning_ : Positioning::Absolute;
 	}
 
 	void Sound::SetPositioning(Positioning positioning) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetPositioning, m_SoundID, {}, { (uint64_t)positioning })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 		
-		ma_sound_set_positioning(sound, (ma_positioning)positioning);
-		Context::GetSoundInternalData(m_SoundID)->Positioning_ = positioning;
+		ma_sound_set_positioning((ma_sound*)sound, (ma_positioning)positioning);
+		data->Positioning_ = positioning;
+		Context::GetSoundSpatialStore(m_SoundID)->SetPositioning(m_SoundID.GetIndex(), positioning);
 	}
 
 	uint32_t Sound::GetListenerIndex() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return 0;
+		}
 		
-		return (uint32_t)ma_sound_get_listener_index(sound);
+		return (uint32_t)ma_sound_get_listener_index((ma_sound*)sound);
 	}
 
 	uint32_t Sound::GetPinnedListenerIndex() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return UINT32_MAX;
+		}
 		
-		return (uint32_t)ma_sound_get_pinned_listener_index(sound);
+		return (uint32_t)ma_sound_get_pinned_listener_index((ma_sound*)sound);
 	}
 
 	void Sound::SetPinnedListenerIndex(uint32_t listenerIndex) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetPinnedListenerIndex, m_SoundID, {}, { listenerIndex })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 		
-		ma_sound_set_pinned_listener_index(sound, listenerIndex);
+		ma_sound_set_pinned_listener_index((ma_sound*)sound, listenerIndex);
+		Context::GetSoundSpatialStore(m_SoundID)->SetPinnedListener(m_SoundID.GetIndex(), listenerIndex);
 	}
 
 	float Sound::GetCurrentFadeVolume() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return 0.0f;
+		}
 		
-		return ma_sound_get_current_fade_volume(sound);
+		return ma_sound_get_current_fade_volume((ma_sound*)sound);
 	}
 
 	float Sound::GetCursorInSeconds() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return 0.0f;
+		}
 		
+		if (Context::GetSoundSpatialStore(m_SoundID)->HasFlag(m_SoundID.GetIndex(), SpatialFlag_Virtual))
+		{
+			return data->SampleRate != 0 ? (float)Context::GetVirtualCursor(m_SoundID) / (float)data->SampleRate : 0.0f;
+		}
+
 		float cursor = 0.0f;
-		ma_result res = ma_sound_get_cursor_in_seconds(sound, &cursor);
+		ma_result res = ma_sound_get_cursor_in_seconds((ma_sound*)sound, &cursor);
 		
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to get cursor of sound with ID: '{}'", uint64_t(m_SoundID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::CursorFailed, m_SoundID);
 			return 0.0f;
 		}
 
@@ -441,16 +732,25 @@ namespace Wave {
 
 	uint64_t Sound::GetCursorInPCMFrames() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return 0;
+		}
+
+		if (Context::GetSoundSpatialStore(m_SoundID)->HasFlag(m_SoundID.GetIndex(), SpatialFlag_Virtual))
+		{
+			return Context::GetVirtualCursor(m_SoundID);
+		}
 
 		uint64_t cursor = 0;
-		ma_result res = ma_sound_get_cursor_in_pcm_frames(sound, &cursor);
+		ma_result res = ma_sound_get_cursor_in_pcm_frames((ma_sound*)sound, &cursor);
 
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to get cursor of sound with ID: '{}'", uint64_t(m_SoundID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::CursorFailed, m_SoundID);
 			return 0;
 		}
 
@@ -459,181 +759,358 @@ namespace Wave {
 
 	uint64_t Sound::GetTimeInMilliseconds() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return 0;
+		}
 
-		return ma_sound_get_time_in_milliseconds(sound);
+		return ma_sound_get_time_in_milliseconds((ma_sound*)sound);
 	}
 
 	uint64_t Sound::GetTimeInPCMFrames() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return 0;
+		}
 		
-		return ma_sound_get_time_in_pcm_frames(sound);
+		return ma_sound_get_time_in_pcm_frames((ma_sound*)sound);
 	}
 
 	void Sound::SetStartTimeInMilliseconds(uint64_t startTimeInMilliseconds)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetStartTimeInMilliseconds, m_SoundID, {}, { startTimeInMilliseconds })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_start_time_in_milliseconds(sound, startTimeInMilliseconds);
+		ma_sound_set_start_time_in_milliseconds((ma_sound*)sound, startTimeInMilliseconds);
 	}
 
 	void Sound::SetStopTimeInMilliseconds(uint64_t stopTimeInMilliseconds)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetStopTimeInMilliseconds, m_SoundID, {}, { stopTimeInMilliseconds })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_stop_time_in_milliseconds(sound, stopTimeInMilliseconds);
+		ma_sound_set_stop_time_in_milliseconds((ma_sound*)sound, stopTimeInMilliseconds);
 	}
 
 	void Sound::SetStopTimeWithFadeInMilliseconds(uint64_t stopTimeInMilliseconds, uint64_t fadeLengthInMilliseconds)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetStopTimeWithFadeInMilliseconds, m_SoundID, {}, { stopTimeInMilliseconds, fadeLengthInMilliseconds })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_stop_time_with_fade_in_milliseconds(sound, stopTimeInMilliseconds, fadeLengthInMilliseconds);
+		ma_sound_set_stop_time_with_fade_in_milliseconds((ma_sound*)sound, stopTimeInMilliseconds, fadeLengthInMilliseconds);
 	}
 
 	void Sound::SetStartTimeInPCMFrames(uint64_t startTimeInFrames)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetStartTimeInPCMFrames, m_SoundID, {}, { startTimeInFrames })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_start_time_in_pcm_frames(sound, startTimeInFrames);
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_start_time_in_pcm_frames((ma_sound*)sound, startTimeInFrames);
 	}
 
 	void Sound::SetStopTimeInPCMFrames(uint64_t stopTimeInFrames)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetStopTimeInPCMFrames, m_SoundID, {}, { stopTimeInFrames })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
 
-		ma_sound_set_stop_time_in_pcm_frames(sound, stopTimeInFrames);
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_stop_time_in_pcm_frames((ma_sound*)sound, stopTimeInFrames);
 	}
 
 	void Sound::SetStopTimeWithFadeInPCMFrames(uint64_t stopTimeInFrames, uint64_t fadeLengthInFrames)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetStopTimeWithFadeInPCMFrames, m_SoundID, {}, { stopTimeInFrames, fadeLengthInFrames })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
 
-		ma_sound_set_stop_time_with_fade_in_pcm_frames(sound, stopTimeInFrames, fadeLengthInFrames);
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_stop_time_with_fade_in_pcm_frames((ma_sound*)sound, stopTimeInFrames, fadeLengthInFrames);
 	}
 
 	void Sound::SetFadeInMilliseconds(float volumeStart, float volumeEnd, uint64_t fadeLengthInMilliseconds)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetFadeInMilliseconds, m_SoundID, { volumeStart, volumeEnd }, { fadeLengthInMilliseconds })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_fade_in_milliseconds(sound, volumeStart, volumeEnd, fadeLengthInMilliseconds);
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_fade_in_milliseconds((ma_sound*)sound, volumeStart, volumeEnd, fadeLengthInMilliseconds);
 	}
 
 	void Sound::SetFadeStartInMilliseconds(float volumeStart, float volumeEnd, uint64_t fadeLengthInMilliseconds, uint64_t absoluteGlobalTimeInMilliseconds)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetFadeStartInMilliseconds, m_SoundID, { volumeStart, volumeEnd }, { fadeLengthInMilliseconds, absoluteGlobalTimeInMilliseconds })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 		
-		ma_sound_set_fade_start_in_milliseconds(sound, volumeStart, volumeEnd, fadeLengthInMilliseconds, absoluteGlobalTimeInMilliseconds);
+		ma_sound_set_fade_start_in_milliseconds((ma_sound*)sound, volumeStart, volumeEnd, fadeLengthInMilliseconds, absoluteGlobalTimeInMilliseconds);
 	}
 
 	void Sound::SetFadeInPCMFrames(float volumeStart, float volumeEnd, uint64_t fadeLengthInFrames)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetFadeInPCMFrames, m_SoundID, { volumeStart, volumeEnd }, { fadeLengthInFrames })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 		
-		ma_sound_set_fade_in_pcm_frames(sound, volumeStart, volumeEnd, fadeLengthInFrames);
+		ma_sound_set_fade_in_pcm_frames((ma_sound*)sound, volumeStart, volumeEnd, fadeLengthInFrames);
 	}
 
 	void Sound::SetFadeStartInPCMFrames(float volumeStart, float volumeEnd, uint64_t fadeLengthInFrames, uint64_t absoluteGlobalTimeInFrames)
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetFadeStartInPCMFrames, m_SoundID, { volumeStart, volumeEnd }, { fadeLengthInFrames, absoluteGlobalTimeInFrames })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_fade_start_in_pcm_frames(sound, volumeStart, volumeEnd, fadeLengthInFrames, absoluteGlobalTimeInFrames);
+		ma_sound_set_fade_start_in_pcm_frames((ma_sound*)sound, volumeStart, volumeEnd, fadeLengthInFrames, absoluteGlobalTimeInFrames);
 	}
 
 	float Sound::GetLengthInSeconds() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->LengthInSeconds;
+		return data != nullptr ? data->LengthInSeconds : 0.0f;
 	}
 
 	uint64_t Sound::GetLengthInPCMFrames() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 		
-		return Context::GetSoundInternalData(m_SoundID)->LengthInSeconds;
+		return data != nullptr ? data->LengthInPCMFrames : 0;
 	}
 
 	bool Sound::IsPlaying() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return false;
+		}
 
-		return (bool)ma_sound_is_playing(sound);
+		return (bool)ma_sound_is_playing((ma_sound*)sound) || Context::GetSoundSpatialStore(m_SoundID)->HasFlag(m_SoundID.GetIndex(), SpatialFlag_Virtual);
 	}
 
 	bool Sound::IsPaused() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->IsPaused;
+		return data != nullptr && data->IsPaused;
 	}
 
 	bool Sound::IsLooping() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->IsLooping;
+		return data != nullptr && data->IsLooping;
 	}
 
 	void Sound::SetLooping(bool loop) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetLooping, m_SoundID, {}, { (uint64_t)loop })) != DeferResult::Immediate)
+			return;
+
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
 
-		ma_sound_set_looping(sound, (ma_bool32)loop);
-		Context::GetSoundInternalData(m_SoundID)->IsLooping = loop;
+		ma_sound_set_looping((ma_sound*)sound, (ma_bool32)loop);
+		data->IsLooping = loop;
 	}
 
 	bool Sound::IsSpacialized() const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
 
-		return Context::GetSoundInternalData(m_SoundID)->Spacialized;
+		return data != nullptr && data->Spacialized;
 	}
 
 	void Sound::SetSpacialized(bool spacialized) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetSpacialized, m_SoundID, {}, { (uint64_t)spacialized })) != DeferResult::Immediate)
+			return;
 
-		ma_sound_set_spatialization_enabled(sound, spacialized);
-		Context::GetSoundInternalData(m_SoundID)->Spacialized = spacialized;
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return;
+		}
+
+		ma_sound_set_spatialization_enabled((ma_sound*)sound, spacialized);
+		data->Spacialized = spacialized;
+		Context::GetSoundSpatialStore(m_SoundID)->SetSpatialized(m_SoundID.GetIndex(), spacialized);
 	}
 
 	bool Sound::SeekToPCMFrame(uint64_t frameIndex) const
 	{
-		ma_sound* sound = (ma_sound*)Context::GetSoundInternal(m_SoundID);
-		WAVE_ASSERT(sound, "Invalid sound ID: '%zu'", uint64_t(m_SoundID));
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundSeek, m_SoundID, {}, { frameIndex })); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
 
-		ma_result res = ma_sound_seek_to_pcm_frame(sound, frameIndex);
+		void* sound = nullptr;
+		SoundData* data = nullptr;
+
+		if (!Context::ResolveSound(m_SoundID, &sound, &data))
+		{
+			return false;
+		}
+
+		if (Context::GetSoundSpatialStore(m_SoundID)->HasFlag(m_SoundID.GetIndex(), SpatialFlag_Virtual))
+		{
+			Context::SetVirtualCursor(m_SoundID, frameIndex);
+			return true;
+		}
+
+		ma_result res = ma_sound_seek_to_pcm_frame((ma_sound*)sound, frameIndex);
 
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to seek to frame '{}' on sound with ID: '{}'", frameIndex, uint64_t(m_SoundID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::SeekFailed, m_SoundID, frameIndex);
 			return false;
 		}
 
 		return true;
 	}
 
+	uint8_t Sound::GetPriority() const
+	{
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
+
+		return data != nullptr ? data->Priority : 0;
+	}
+
+	void Sound::SetPriority(uint8_t priority) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetPriority, m_SoundID, {}, { priority })) != DeferResult::Immediate)
+			return;
+
+		SoundData* data = Context::GetSoundInternalData(m_SoundID);
+
+		if (data != nullptr)
+		{
+			data->Priority = priority;
+		}
+	}
+
+	float Sound::GetOcclusion() const
+	{
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
+
+		return data != nullptr ? data->Occlusion : 0.0f;
+	}
+
+	void Sound::SetOcclusion(float occlusion) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundSetOcclusion, m_SoundID, { occlusion })) != DeferResult::Immediate)
+			return;
+
+		Context::SetSoundOcclusion(m_SoundID, occlusion);
+	}
+
+	SoundLoadState Sound::GetLoadState() const
+	{
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
+
+		// A stale handle can't be used for anything but DestroySound either
+		return data != nullptr ? data->LoadState : SoundLoadState::Failed;
+	}
+
+	SoundLoadMode Sound::GetLoadMode() const
+	{
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
+
+		return data != nullptr ? data->LoadMode : SoundLoadMode::Decode;
+	}
+
+	ID Sound::GetGroupID() const
+	{
+		const SoundData* data = Context::GetSoundInternalData(m_SoundID);
+
+		return data != nullptr ? data->GroupID : ID(ID::Invalid);
+	}
+
 }
@@ -5,38 +5,86 @@
 
 namespace Wave {
 
+	enum class SoundLoadState : uint8_t
+	{
+		Loaded = 0, /* Ready to play. */
+		Loading,    /* Still being opened on a loader thread, see Context::CreateSoundFromFileAsync. */
+		Failed,     /* Loading failed, the sound can only be destroyed. */
+	};
+
+	enum class SoundLoadMode : uint8_t
+	{
+		Auto = 0, /* Decode when the decoded file is below ContextSettings::StreamingThreshold, stream otherwise. */
+		Decode,   /* Decode the whole file into memory up front, shared through the decoded sound cache. */
+		Stream,   /* Decode on a background thread into a small double-buffered window, for music and ambience. */
+	};
+
+	/* Cold per-sound configuration. Transforms, volume and distance attenuation live in
+	   the context's SoundSpatialStore so per-frame passes don't have to touch this. */
 	struct SoundData
 	{
-		float Volume = 1.0f;
 		float Pitch = 1.0f;
 		float DopplerFactor = 0.0f;
-		float Falloff = 1.0f;
-
-		float MinGain = 1.0f;
-		float MaxGain = 1.0f;
-		float MinDistance = 1.0f;
-		float MaxDistance = 1.0f;
 
 		float DirectionalAttenuationFactor = 1.0f;
 
-		float Pan = 1.0f;
+		float Pan = 0.0f;
 		PanMode PanMode = PanMode::Balance;
 
 		Positioning Positioning_ = Positioning::Absolute;
 
 		float LengthInSeconds = 0.0f;
 		uint64_t LengthInPCMFrames = 0;
+		uint32_t SampleRate = 0;
 
-		Vec3 Position = Vec3(0.0f);
-		Vec3 Direction = Vec3(0.0f);
-		Vec3 Velocity = Vec3(0.0f);
+		// Where a virtualized sound was and when, used to work out where it would be now
+		uint64_t VirtualCursorInPCMFrames = 0;
+		uint64_t VirtualStartTimeInPCMFrames = 0;
 
 		AudioCone Cone;
 		AttenuationModel Model = AttenuationModel::Inverse;
 
+		// Higher priority voices are kept when the engine runs out of voices
+		uint8_t Priority = 128;
+
+		// The sound group the sound is mixed into, ID::Invalid when it goes straight to the engine
+		ID GroupID = ID::Invalid;
+
+		float Occlusion = 0.0f;
+
 		bool IsPaused = false;
+		bool PausedByGroup = false;
 		bool IsLooping = false;
 		bool Spacialized = true;
+		bool WasStolen = false;
+		bool IsVoiceTracked = false;
+
+		// Only ever touched by the thread calling Context::Update, the loader threads report through the context
+		SoundLoadState LoadState = SoundLoadState::Loaded;
+		SoundLoadMode LoadMode = SoundLoadMode::Decode;
+		bool PlayPending = false;
+		bool DestroyPending = false;
+	};
+
+	enum class SoundUpdateFlags : uint32_t
+	{
+		None      = 0,
+		Position  = 1 << 0,
+		Velocity  = 1 << 1,
+		Direction = 1 << 2,
+		Volume    = 1 << 3,
+		All       = Position | Velocity | Direction | Volume,
+	};
+
+	/* A single entry for Context::UpdateSounds, only the fields selected by Flags are applied. */
+	struct SoundUpdate
+	{
+		ID SoundID = ID::Invalid;
+		Vec3 Position = Vec3(0.0f);
+		Vec3 Velocity = Vec3(0.0f);
+		Vec3 Direction = Vec3(0.0f);
+		float Volume = 1.0f;
+		uint32_t Flags = (uint32_t)SoundUpdateFlags::All;
 	};
 
 	class Sound
@@ -45,6 +93,7 @@ namespace Wave {
 		inline Sound(ID id) : m_SoundID(id) { }
 		~Sound() = default;
 
+		// Playing a sound that is still loading starts it as soon as it is ready
 		bool Play() const;
 		bool Restart() const;
 		bool Pause() const;
@@ -59,16 +108,16 @@ namespace Wave {
 		float GetDopplerFactor() const;
 		void SetDopplerFactor(float dopplerFactor) const;
 
-		const Vec3& GetPosition() const;
+		Vec3 GetPosition() const;
 		void SetPosition(const Vec3& position) const;
 
-		const Vec3& GetDirection() const;
+		Vec3 GetDirection() const;
 		void SetDirection(const Vec3& direction) const;
 
-		const Vec3& GetVelocity() const;
+		Vec3 GetVelocity() const;
 		void SetVelocity(const Vec3& velocity) const;
 
-		const Vec3& GetDirectionToListener() const;
+		Vec3 GetDirectionToListener() const;
 
 		const AudioCone& GetAudioCone() const;
 		void SetAudioCone(const AudioCone& cone) const;
@@ -142,6 +191,23 @@ namespace Wave {
 
 		bool SeekToPCMFrame(uint64_t frameIndex) const;
 
+		uint8_t GetPriority() const;
+		void SetPriority(uint8_t priority) const;
+
+		// 0 for a clear line of sight up to 1 for fully blocked, muffles the sound with a low-pass
+		// and gain configured by the engine's OcclusionSettings. The filter is only added once needed.
+		float GetOcclusion() const;
+		void SetOcclusion(float occlusion) const;
+
+		SoundLoadState GetLoadState() const;
+
+		// ID::Invalid when the sound isn't routed into a sound group
+		ID GetGroupID() const;
+
+		// How the sound ended up being loaded, never Auto
+		SoundLoadMode GetLoadMode() const;
+		inline bool IsLoaded() const { return GetLoadState() == SoundLoadState::Loaded; }
+
 		inline ID GetID() const { return m_SoundID; }
 
 		inline operator ID() const { return m_SoundID; }
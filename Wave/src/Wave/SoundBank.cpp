@@ -0,0 +1,211 @@
+#include "SoundBank.h"
+
+#include <algorithm>
+#include <format>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace Wave {
+
+	SoundBank::~SoundBank()
+	{
+		Close();
+	}
+
+	bool SoundBank::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+#if defined(_WIN32)
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			m_LastErrorMsg = std::format("Failed to open sound bank: '{}'", path.string());
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			m_LastErrorMsg = std::format("Sound bank is empty: '{}'", path.string());
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+		if (view == nullptr)
+		{
+			if (mapping != nullptr)
+				CloseHandle(mapping);
+			CloseHandle(file);
+			m_LastErrorMsg = std::format("Failed to map sound bank: '{}'", path.string());
+			return false;
+		}
+
+		m_FileHandle = file;
+		m_MappingHandle = mapping;
+		m_Data = (const uint8_t*)view;
+		m_Size = (size_t)size.QuadPart;
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			m_LastErrorMsg = std::format("Failed to open sound bank: '{}'", path.string());
+			return false;
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close(fd);
+			m_LastErrorMsg = std::format("Sound bank is empty: '{}'", path.string());
+			return false;
+		}
+
+		void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		// The mapping keeps the file alive on its own
+		close(fd);
+
+		if (view == MAP_FAILED)
+		{
+			m_LastErrorMsg = std::format("Failed to map sound bank: '{}'", path.string());
+			return false;
+		}
+
+		m_Data = (const uint8_t*)view;
+		m_Size = (size_t)info.st_size;
+#endif
+
+		if (!Validate())
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void SoundBank::Close()
+	{
+		if (m_Data == nullptr)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		UnmapViewOfFile(m_Data);
+		CloseHandle(m_MappingHandle);
+		CloseHandle(m_FileHandle);
+		m_MappingHandle = nullptr;
+		m_FileHandle = nullptr;
+#else
+		munmap((void*)m_Data, m_Size);
+#endif
+
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Entries = nullptr;
+		m_EntryCount = 0;
+	}
+
+	const SoundBankEntry* SoundBank::Find(uint64_t nameHash) const
+	{
+		const SoundBankEntry* end = m_Entries + m_EntryCount;
+		const SoundBankEntry* it = std::lower_bound(m_Entries, end, nameHash, [](const SoundBankEntry& entry, uint64_t hash)
+		{
+			return entry.NameHash < hash;
+		});
+
+		if (it == end || it->NameHash != nameHash)
+		{
+			return nullptr;
+		}
+
+		return it;
+	}
+
+	bool SoundBank::Validate()
+	{
+		if (m_Size < sizeof(SoundBankHeader))
+		{
+			m_LastErrorMsg = "Sound bank is too small to hold a header";
+			return false;
+		}
+
+		const SoundBankHeader* header = (const SoundBankHeader*)m_Data;
+
+		if (header->Magic != SoundBankMagic)
+		{
+			m_LastErrorMsg = "File is not a sound bank";
+			return false;
+		}
+
+		if (header->Version != SoundBankVersion)
+		{
+			m_LastErrorMsg = std::format("Unsupported sound bank version: {}, expected {}", header->Version, SoundBankVersion);
+			return false;
+		}
+
+		uint64_t indexSize = (uint64_t)header->EntryCount * sizeof(SoundBankEntry);
+
+		if (header->IndexOffset % alignof(SoundBankEntry) != 0 || header->IndexOffset > m_Size || indexSize > m_Size - header->IndexOffset)
+		{
+			m_LastErrorMsg = "Sound bank index is out of bounds";
+			return false;
+		}
+
+		m_Entries = (const SoundBankEntry*)(m_Data + header->IndexOffset);
+		m_EntryCount = header->EntryCount;
+
+		// Only the index is checked here, touching every payload would fault in the whole file
+		for (uint32_t i = 0; i < m_EntryCount; i++)
+		{
+			const SoundBankEntry& entry = m_Entries[i];
+
+			if (entry.Offset > m_Size || entry.Length > m_Size - entry.Offset)
+			{
+				m_LastErrorMsg = std::format("Sound bank entry {} is out of bounds", i);
+				return false;
+			}
+
+			if (entry.Codec != SoundBankCodec::Encoded && entry.Codec != SoundBankCodec::PCMS16 && entry.Codec != SoundBankCodec::PCMF32)
+			{
+				m_LastErrorMsg = std::format("Sound bank entry {} has an unknown codec: {}", i, (uint16_t)entry.Codec);
+				return false;
+			}
+
+			if (entry.Channels == 0)
+			{
+				m_LastErrorMsg = std::format("Sound bank entry {} has no channels", i);
+				return false;
+			}
+
+			// Raw PCM is read by the mixer straight out of the mapping, the frames it claims must fit the payload
+			if (entry.Codec != SoundBankCodec::Encoded)
+			{
+				uint64_t frameSize = (uint64_t)entry.Channels * (entry.Codec == SoundBankCodec::PCMS16 ? sizeof(int16_t) : sizeof(float));
+
+				if (entry.LengthInPCMFrames > entry.Length / frameSize)
+				{
+					m_LastErrorMsg = std::format("Sound bank entry {} holds fewer frames than it claims", i);
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+}
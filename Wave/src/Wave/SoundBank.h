@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <filesystem>
+
+namespace Wave {
+
+	// On-disk layout of a sound bank (little-endian):
+	//
+	//   SoundBankHeader
+	//   SoundBankEntry[EntryCount]  sorted by NameHash
+	//   payloads                    each aligned to SoundBankPayloadAlignment
+	//
+	// The file is mapped as-is, the index is binary searched in place and payloads
+	// are handed to the decoder without being copied.
+	inline constexpr uint32_t SoundBankMagic = 0x4B425657; // "WVBK"
+	inline constexpr uint32_t SoundBankVersion = 1;
+	inline constexpr uint64_t SoundBankPayloadAlignment = 16;
+
+	enum class SoundBankCodec : uint16_t
+	{
+		Encoded = 0, /* A complete wav/flac/mp3 file, decoded on playback. */
+		PCMS16,      /* Raw interleaved signed 16-bit samples. */
+		PCMF32,      /* Raw interleaved 32-bit float samples. */
+	};
+
+	struct SoundBankHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Reserved;
+		uint64_t IndexOffset;
+		uint64_t DataOffset;
+	};
+
+	struct SoundBankEntry
+	{
+		uint64_t NameHash;
+		uint64_t Offset; /* From the start of the file. */
+		uint64_t Length; /* In bytes. */
+		uint64_t LengthInPCMFrames;
+		uint32_t SampleRate;
+		uint16_t Channels;
+		SoundBankCodec Codec;
+	};
+
+	static_assert(sizeof(SoundBankHeader) == 32, "SoundBankHeader layout changed!");
+	static_assert(sizeof(SoundBankEntry) == 40, "SoundBankEntry layout changed!");
+
+	// Read-only view of a sound bank file mapped into memory. Sounds created from a bank
+	// reference its payloads directly, so the bank must outlive every one of them.
+	class SoundBank
+	{
+	public:
+		SoundBank() = default;
+		~SoundBank();
+
+		SoundBank(const SoundBank&) = delete;
+		SoundBank& operator=(const SoundBank&) = delete;
+
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		// Returns nullptr if no entry matches
+		const SoundBankEntry* Find(uint64_t nameHash) const;
+		inline const SoundBankEntry* Find(std::string_view name) const { return Find(HashName(name)); }
+
+		inline const uint8_t* GetPayload(const SoundBankEntry& entry) const { return m_Data + entry.Offset; }
+
+		inline const SoundBankEntry* GetEntries() const { return m_Entries; }
+		inline uint32_t GetEntryCount() const { return m_EntryCount; }
+		inline bool IsOpen() const { return m_Data != nullptr; }
+
+		inline const std::string& GetLastErrorMsg() const { return m_LastErrorMsg; }
+
+		// FNV-1a over the entry name, the packer stores names as paths relative
+		// to the packed directory with forward slashes, e.g. "sfx/footstep_01.wav"
+		static constexpr uint64_t HashName(std::string_view name)
+		{
+			uint64_t hash = 0xcbf29ce484222325;
+
+			for (char c : name)
+			{
+				hash ^= (uint8_t)c;
+				hash *= 0x100000001b3;
+			}
+
+			return hash;
+		}
+
+	private:
+		bool Validate();
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+		const SoundBankEntry* m_Entries = nullptr;
+		uint32_t m_EntryCount = 0;
+
+#if defined(_WIN32)
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+#endif
+
+		std::string m_LastErrorMsg = "";
+	};
+
+}
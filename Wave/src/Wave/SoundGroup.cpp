@@ -1,47 +1,460 @@
 #include "SoundGroup.h"
 
 #include "Wave/Context.h"
+#include "Wave/Sound.h"
 #include "Wave/Assert.h"
 #include "Wave/Utils.h"
+#include "Wave/CommandQueue.h"
 
 #include <miniaudio/miniaudio.h>
 
-#include <format>
-
 namespace Wave {
 
 	bool SoundGroup::Play() const
 	{
-		ma_sound_group* soundGroup = (ma_sound_group*)Context::GetSoundGroupInternal(m_SoundGroupID);
-		WAVE_ASSERT(soundGroup, "Invalid sound group ID: '%zu'", uint64_t(m_SoundGroupID));
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundGroupPlay, m_SoundGroupID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
 
-		ma_result res = ma_sound_start(soundGroup);
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return false;
+		}
+
+		ma_result res = ma_sound_start((ma_sound_group*)group);
 
 		if (res != MA_SUCCESS)
 		{
-			std::string err = std::format("Failed to start sound group with ID: '{}'", uint64_t(m_SoundGroupID));
-			Context::SetErrorMsg(err);
+			SetLastError(ErrorCode::StartFailed, m_SoundGroupID, 0, 0, "sound group");
 			return false;
 		}
 
-		Context::GetSoundGroupInternalData(m_SoundGroupID)->IsPaused = false;
+		Context::PruneSoundGroup(m_SoundGroupID);
+
+		// Only resume what the group's Pause paused, anything paused on its own stays paused
+		for (ID childID : data->Children)
+		{
+			if (Context::GetSoundGroupInternalData(childID)->PausedByParent)
+			{
+				SoundGroup(childID).Play();
+			}
+		}
+
+		for (ID soundID : data->Sounds)
+		{
+			SoundData* soundData = Context::GetSoundInternalData(soundID);
+
+			if (soundData->IsPaused && soundData->PausedByGroup)
+			{
+				Sound(soundID).Play();
+			}
+		}
+
+		data->IsPaused = false;
+		data->PausedByParent = false;
 
 		return true;
 	}
 
 	bool SoundGroup::Restart() const
 	{
-		return false;
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundGroupRestart, m_SoundGroupID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		if (data == nullptr)
+		{
+			return false;
+		}
+
+		Context::PruneSoundGroup(m_SoundGroupID);
+
+		for (ID childID : data->Children)
+		{
+			SoundGroup(childID).Restart();
+		}
+
+		for (ID soundID : data->Sounds)
+		{
+			Sound(soundID).Restart();
+		}
+
+		return true;
 	}
 
 	bool SoundGroup::Pause() const
 	{
-		return false;
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundGroupPause, m_SoundGroupID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return false;
+		}
+
+		if (data->IsPaused)
+		{
+			return true;
+		}
+
+		Context::PruneSoundGroup(m_SoundGroupID);
+
+		// Pausing the sounds themselves frees their voices and keeps virtual voices from being resumed
+		for (ID childID : data->Children)
+		{
+			SoundGroupData* childData = Context::GetSoundGroupInternalData(childID);
+
+			if (!childData->IsPaused)
+			{
+				SoundGroup(childID).Pause();
+				childData->PausedByParent = true;
+			}
+		}
+
+		for (ID soundID : data->Sounds)
+		{
+			Sound sound(soundID);
+
+			if (sound.IsPlaying())
+			{
+				sound.Pause();
+				Context::GetSoundInternalData(soundID)->PausedByGroup = true;
+			}
+		}
+
+		// Holds anything started into the group while it's paused
+		ma_result res = ma_sound_stop((ma_sound_group*)group);
+
+		if (res != MA_SUCCESS)
+		{
+			SetLastError(ErrorCode::StopFailed, m_SoundGroupID, 0, 0, "sound group");
+			return false;
+		}
+
+		data->IsPaused = true;
+
+		return true;
 	}
 
 	bool SoundGroup::Stop() const
 	{
-		return false;
+		if (DeferResult deferred = Context::DeferCommand(MakeCommand(CommandType::SoundGroupStop, m_SoundGroupID)); deferred != DeferResult::Immediate)
+			return deferred == DeferResult::Queued;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return false;
+		}
+
+		Context::PruneSoundGroup(m_SoundGroupID);
+
+		for (ID childID : data->Children)
+		{
+			SoundGroup(childID).Stop();
+		}
+
+		for (ID soundID : data->Sounds)
+		{
+			Sound(soundID).Stop();
+		}
+
+		ma_result res = ma_sound_start((ma_sound_group*)group);
+
+		if (res != MA_SUCCESS)
+		{
+			SetLastError(ErrorCode::StartFailed, m_SoundGroupID, 0, 0, "sound group");
+			return false;
+		}
+
+		data->IsPaused = false;
+		data->PausedByParent = false;
+
+		return true;
+	}
+
+	bool SoundGroup::IsPaused() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr && data->IsPaused;
+	}
+
+	float SoundGroup::GetVolume() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->Volume : 0.0f;
+	}
+
+	void SoundGroup::SetVolume(float volume) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetVolume, m_SoundGroupID, { volume })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_volume((ma_sound_group*)group, volume);
+		data->Volume = volume;
+	}
+
+	float SoundGroup::GetPitch() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->Pitch : 0.0f;
+	}
+
+	void SoundGroup::SetPitch(float pitch) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetPitch, m_SoundGroupID, { pitch })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_pitch((ma_sound_group*)group, pitch);
+		data->Pitch = pitch;
+	}
+
+	float SoundGroup::GetPan() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->Pan : 0.0f;
+	}
+
+	void SoundGroup::SetPan(float pan) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetPan, m_SoundGroupID, { pan })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_pan((ma_sound_group*)group, pan);
+		data->Pan = pan;
+	}
+
+	Vec3 SoundGroup::GetPosition() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->Position : Vec3(0.0f);
+	}
+
+	void SoundGroup::SetPosition(const Vec3& position) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetPosition, m_SoundGroupID, { position.X, position.Y, position.Z })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_position((ma_sound_group*)group, position.X, position.Y, position.Z);
+		data->Position = position;
+	}
+
+	Vec3 SoundGroup::GetDirection() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->Direction : Vec3(0.0f);
+	}
+
+	void SoundGroup::SetDirection(const Vec3& direction) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetDirection, m_SoundGroupID, { direction.X, direction.Y, direction.Z })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_direction((ma_sound_group*)group, direction.X, direction.Y, direction.Z);
+		data->Direction = direction;
+	}
+
+	Vec3 SoundGroup::GetVelocity() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->Velocity : Vec3(0.0f);
+	}
+
+	void SoundGroup::SetVelocity(const Vec3& velocity) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetVelocity, m_SoundGroupID, { velocity.X, velocity.Y, velocity.Z })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_velocity((ma_sound_group*)group, velocity.X, velocity.Y, velocity.Z);
+		data->Velocity = velocity;
+	}
+
+	float SoundGroup::GetMinDistance() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->MinDistance : 0.0f;
+	}
+
+	void SoundGroup::SetMinDistance(float minDistance) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetMinDistance, m_SoundGroupID, { minDistance })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_min_distance((ma_sound_group*)group, minDistance);
+		data->MinDistance = minDistance;
+	}
+
+	float SoundGroup::GetMaxDistance() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->MaxDistance : 0.0f;
+	}
+
+	void SoundGroup::SetMaxDistance(float maxDistance) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetMaxDistance, m_SoundGroupID, { maxDistance })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_max_distance((ma_sound_group*)group, maxDistance);
+		data->MaxDistance = maxDistance;
+	}
+
+	AttenuationModel SoundGroup::GetAttenuationModel() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->Model : AttenuationModel::None;
+	}
+
+	void SoundGroup::SetAttenuationModel(AttenuationModel model) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetAttenuationModel, m_SoundGroupID, {}, { (uint64_t)model })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_attenuation_model((ma_sound_group*)group, (ma_attenuation_model)model);
+		data->Model = model;
+	}
+
+	bool SoundGroup::IsSpacialized() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr && data->Spacialized;
+	}
+
+	void SoundGroup::SetSpacialized(bool spacialized) const
+	{
+		if (Context::DeferCommand(MakeCommand(CommandType::SoundGroupSetSpacialized, m_SoundGroupID, {}, { (uint64_t)spacialized })) != DeferResult::Immediate)
+			return;
+
+		void* group = nullptr;
+		SoundGroupData* data = nullptr;
+
+		if (!Context::ResolveSoundGroup(m_SoundGroupID, &group, &data))
+		{
+			return;
+		}
+
+		ma_sound_group_set_spatialization_enabled((ma_sound_group*)group, (ma_bool32)spacialized);
+		data->Spacialized = spacialized;
+	}
+
+	bool SoundGroup::AddEffect(const BusEffect& effect) const
+	{
+		return Context::AddSoundGroupEffect(m_SoundGroupID, effect);
+	}
+
+	bool SoundGroup::UpdateEffect(uint32_t index, const BusEffect& effect) const
+	{
+		return Context::UpdateSoundGroupEffect(m_SoundGroupID, index, effect);
+	}
+
+	void SoundGroup::ClearEffects() const
+	{
+		Context::ClearSoundGroupEffects(m_SoundGroupID);
+	}
+
+	uint32_t SoundGroup::GetEffectCount() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->EffectCount : 0;
+	}
+
+	ID SoundGroup::GetParentGroupID() const
+	{
+		const SoundGroupData* data = Context::GetSoundGroupInternalData(m_SoundGroupID);
+
+		return data != nullptr ? data->ParentGroupID : ID(ID::Invalid);
 	}
 
 }
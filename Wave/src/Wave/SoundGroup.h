@@ -1,30 +1,135 @@
 #pragma once
 
+#include "Wave/Types.h"
 #include "Wave/ID.h"
 
+#include <vector>
+
 namespace Wave {
-	
+
+	enum class BusEffectType : uint8_t
+	{
+		LowPass = 0, /* Butterworth low-pass filter. */
+		HighPass,    /* Butterworth high-pass filter. */
+		BandPass,    /* Band-pass filter centered on CutoffFrequency. */
+		Delay,       /* Feedback delay (echo). */
+		Custom,      /* Runs Callback on the mixed bus, e.g. a reverb shared by every sound in the group. */
+	};
+
+	// Called on the audio thread with the bus's mix for this period, processes 'frames' in place.
+	// Must not block, allocate or call back into Wave.
+	typedef void(*BusEffectCallback)(void*, float* frames, uint32_t frameCount, uint32_t channels);
+
+	/* An insert on a sound group's output, effects run in the order they were added. */
+	struct BusEffect
+	{
+		BusEffectType Type = BusEffectType::LowPass;
+
+		float CutoffFrequency = 1000.0f; /* LowPass, HighPass and BandPass, in Hz. */
+		uint32_t Order = 2;              /* LowPass, HighPass and BandPass, up to 8. */
+
+		float DelayInSeconds = 0.25f;    /* Delay only, fixed once the effect is added. */
+		float Decay = 0.5f;              /* Delay only, feedback applied to each repeat. */
+		float Wet = 1.0f;                /* Delay only. */
+		float Dry = 1.0f;                /* Delay only. */
+
+		BusEffectCallback Callback = nullptr; /* Custom only. */
+		void* pUserData = nullptr;            /* Custom only, passed to Callback. */
+	};
+
 	struct SoundGroupData
 	{
+		ID EngineID = ID::Invalid;
+		ID ParentGroupID = ID::Invalid;
+
+		float Volume = 1.0f;
+		float Pitch = 1.0f;
+		float Pan = 0.0f;
+		float MinDistance = 1.0f;
+		float MaxDistance = 3.4028235e+38f;
+		AttenuationModel Model = AttenuationModel::Inverse;
+
+		Vec3 Position = Vec3(0.0f);
+		Vec3 Direction = Vec3(0.0f, 0.0f, -1.0f);
+		Vec3 Velocity = Vec3(0.0f);
+
+		// Groups mix sounds that are usually spatialized on their own, so the bus itself isn't by default
+		bool Spacialized = false;
+
 		bool IsPaused = false;
+		bool PausedByParent = false;
+
+		// Routed into this group, pruned lazily as they're destroyed
+		std::vector<ID> Sounds;
+		std::vector<ID> Children;
+
+		uint32_t EffectCount = 0;
 	};
 
+	// A mixing bus. Sounds created into a group and child groups are mixed together, then run
+	// through the group's effects and its volume, pitch, pan and (optional) spatialization before
+	// going on to the parent group or the engine. Pause, Stop and Restart cascade down to every
+	// sound and child group routed into it.
 	class SoundGroup
 	{
 	public:
-		inline SoundGroup(ID soundGroupID, ID parentGroupID = ID::Invalid)
-			: m_SoundGroupID(soundGroupID), m_ParentGroupID(parentGroupID) { }
+		inline SoundGroup(ID soundGroupID) : m_SoundGroupID(soundGroupID) { }
 		~SoundGroup() = default;
 
+		// Resumes the group along with the sounds and child groups its Pause paused
 		bool Play() const;
 		bool Restart() const;
 		bool Pause() const;
+		// Stops and rewinds every sound in the group, the group itself keeps playing new sounds
 		bool Stop() const;
 
+		bool IsPaused() const;
+
+		float GetVolume() const;
+		void SetVolume(float volume) const;
+
+		float GetPitch() const;
+		void SetPitch(float pitch) const;
+
+		float GetPan() const;
+		void SetPan(float pan) const;
+
+		Vec3 GetPosition() const;
+		void SetPosition(const Vec3& position) const;
+
+		Vec3 GetDirection() const;
+		void SetDirection(const Vec3& direction) const;
+
+		Vec3 GetVelocity() const;
+		void SetVelocity(const Vec3& velocity) const;
+
+		float GetMinDistance() const;
+		void SetMinDistance(float minDistance) const;
+
+		float GetMaxDistance() const;
+		void SetMaxDistance(float maxDistance) const;
+
+		AttenuationModel GetAttenuationModel() const;
+		void SetAttenuationModel(AttenuationModel model) const;
+
+		bool IsSpacialized() const;
+		void SetSpacialized(bool spacialized) const;
+
+		// Effects change the bus topology, so unlike the calls above they're never deferred
+		// and must be made from the thread owning the context
+		bool AddEffect(const BusEffect& effect) const;
+		// Changes the parameters of an existing effect, the type and delay length must stay the same
+		bool UpdateEffect(uint32_t index, const BusEffect& effect) const;
+		void ClearEffects() const;
+		uint32_t GetEffectCount() const;
+
+		ID GetParentGroupID() const;
+		inline ID GetID() const { return m_SoundGroupID; }
+
+		inline operator ID() const { return m_SoundGroupID; }
+
 	private:
 		ID m_SoundGroupID = ID::Invalid;
-		ID m_ParentGroupID = ID::Invalid;
-		std::vector<ID> m_Children;
 	};
 
 }
@@ -0,0 +1,259 @@
+#include "SoundSpatialStore.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace Wave {
+
+	SoundSpatialStore::~SoundSpatialStore()
+	{
+		for (uint32_t i = 0; i < MaxPages; i++)
+		{
+			m_Allocator->Delete(m_Pages[i].load(std::memory_order_relaxed));
+		}
+	}
+
+	bool SoundSpatialStore::Reserve(uint32_t count)
+	{
+		for (uint32_t pageIndex = 0; pageIndex * PageSize < count; pageIndex++)
+		{
+			if (pageIndex >= MaxPages || !EnsurePage(pageIndex))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool SoundSpatialStore::Acquire(uint32_t index, uint32_t engineIndex)
+	{
+		uint32_t pageIndex = index / PageSize;
+
+		if (pageIndex >= MaxPages || !EnsurePage(pageIndex))
+		{
+			return false;
+		}
+
+		// Same defaults miniaudio gives a freshly initialized sound
+		SetPosition(index, 0.0f, 0.0f, 0.0f);
+		SetVelocity(index, 0.0f, 0.0f, 0.0f);
+		SetDirection(index, 0.0f, 0.0f, -1.0f);
+		SetVolume(index, 1.0f);
+		SetMinDistance(index, 1.0f);
+		SetMaxDistance(index, FLT_MAX);
+		SetRolloff(index, 1.0f);
+		SetMinGain(index, 0.0f);
+		SetMaxGain(index, 1.0f);
+		SetModel(index, AttenuationModel::Inverse);
+		SetSpatialized(index, true);
+		SetPositioning(index, Positioning::Absolute);
+		SetPinnedListener(index, UINT32_MAX);
+
+		Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+		page.ConeInnerCos[lane] = -2.0f;
+		page.ConeOuterCos[lane] = -3.0f;
+		page.ConeOuterGain[lane] = 0.0f;
+		page.Gain[lane] = 1.0f;
+		page.OcclusionGain[lane] = 1.0f;
+		page.EngineIndex[lane] = engineIndex;
+		page.Flags[lane] = SpatialFlag_Active;
+
+		return true;
+	}
+
+	bool SoundSpatialStore::EnsurePage(uint32_t pageIndex)
+	{
+		if (m_Pages[pageIndex].load(std::memory_order_acquire) != nullptr)
+		{
+			return true;
+		}
+
+		Page* page = m_Allocator->New<Page>();
+
+		if (page == nullptr)
+		{
+			return false;
+		}
+
+		Page* expected = nullptr;
+
+		// Another thread may have published this page first, in which case ours is discarded
+		if (!m_Pages[pageIndex].compare_exchange_strong(expected, page, std::memory_order_acq_rel))
+		{
+			m_Allocator->Delete(page);
+		}
+
+		// Pages are published in order as slots are handed out, so the count only grows
+		uint32_t count = m_PageCount.load(std::memory_order_relaxed);
+		while (count < pageIndex + 1 && !m_PageCount.compare_exchange_weak(count, pageIndex + 1, std::memory_order_release, std::memory_order_relaxed));
+
+		return true;
+	}
+
+	void SoundSpatialStore::Release(uint32_t index)
+	{
+		GetPageFor(index).Flags[GetLane(index)] = SpatialFlag_None;
+	}
+
+	Vec3 SoundSpatialStore::GetPosition(uint32_t index) const
+	{
+		const Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+		return Vec3(page.PositionX[lane], page.PositionY[lane], page.PositionZ[lane]);
+	}
+
+	void SoundSpatialStore::SetPosition(uint32_t index, float x, float y, float z)
+	{
+		Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+		page.PositionX[lane] = x;
+		page.PositionY[lane] = y;
+		page.PositionZ[lane] = z;
+	}
+
+	Vec3 SoundSpatialStore::GetVelocity(uint32_t index) const
+	{
+		const Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+		return Vec3(page.VelocityX[lane], page.VelocityY[lane], page.VelocityZ[lane]);
+	}
+
+	void SoundSpatialStore::SetVelocity(uint32_t index, float x, float y, float z)
+	{
+		Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+		page.VelocityX[lane] = x;
+		page.VelocityY[lane] = y;
+		page.VelocityZ[lane] = z;
+	}
+
+	Vec3 SoundSpatialStore::GetDirection(uint32_t index) const
+	{
+		const Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+		return Vec3(page.DirectionX[lane], page.DirectionY[lane], page.DirectionZ[lane]);
+	}
+
+	void SoundSpatialStore::SetDirection(uint32_t index, float x, float y, float z)
+	{
+		Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+		page.DirectionX[lane] = x;
+		page.DirectionY[lane] = y;
+		page.DirectionZ[lane] = z;
+	}
+
+	float SoundSpatialStore::GetVolume(uint32_t index) const
+	{
+		return GetPageFor(index).Volume[GetLane(index)];
+	}
+
+	void SoundSpatialStore::SetVolume(uint32_t index, float volume)
+	{
+		GetPageFor(index).Volume[GetLane(index)] = volume;
+	}
+
+	float SoundSpatialStore::GetMinDistance(uint32_t index) const
+	{
+		return GetPageFor(index).MinDistance[GetLane(index)];
+	}
+
+	void SoundSpatialStore::SetMinDistance(uint32_t index, float minDistance)
+	{
+		GetPageFor(index).MinDistance[GetLane(index)] = minDistance;
+	}
+
+	float SoundSpatialStore::GetMaxDistance(uint32_t index) const
+	{
+		return GetPageFor(index).MaxDistance[GetLane(index)];
+	}
+
+	void SoundSpatialStore::SetMaxDistance(uint32_t index, float maxDistance)
+	{
+		GetPageFor(index).MaxDistance[GetLane(index)] = maxDistance;
+	}
+
+	float SoundSpatialStore::GetRolloff(uint32_t index) const
+	{
+		return GetPageFor(index).Rolloff[GetLane(index)];
+	}
+
+	void SoundSpatialStore::SetRolloff(uint32_t index, float rolloff)
+	{
+		GetPageFor(index).Rolloff[GetLane(index)] = rolloff;
+	}
+
+	float SoundSpatialStore::GetMinGain(uint32_t index) const
+	{
+		return GetPageFor(index).MinGain[GetLane(index)];
+	}
+
+	void SoundSpatialStore::SetMinGain(uint32_t index, float minGain)
+	{
+		GetPageFor(index).MinGain[GetLane(index)] = minGain;
+	}
+
+	float SoundSpatialStore::GetMaxGain(uint32_t index) const
+	{
+		return GetPageFor(index).MaxGain[GetLane(index)];
+	}
+
+	void SoundSpatialStore::SetMaxGain(uint32_t index, float maxGain)
+	{
+		GetPageFor(index).MaxGain[GetLane(index)] = maxGain;
+	}
+
+	void SoundSpatialStore::SetModel(uint32_t index, AttenuationModel model)
+	{
+		GetPageFor(index).Model[GetLane(index)] = (float)model;
+	}
+
+	void SoundSpatialStore::SetCone(uint32_t index, const AudioCone& cone)
+	{
+		Page& page = GetPageFor(index);
+		uint32_t lane = GetLane(index);
+
+		// A full circle inner angle means the cone has no effect
+		if (cone.InnerAngle >= 6.283185f)
+		{
+			page.ConeInnerCos[lane] = -2.0f;
+			page.ConeOuterCos[lane] = -3.0f;
+		}
+		else
+		{
+			page.ConeInnerCos[lane] = std::cos(cone.InnerAngle * 0.5f);
+			page.ConeOuterCos[lane] = std::cos(cone.OuterAngle * 0.5f);
+		}
+
+		page.ConeOuterGain[lane] = cone.OuterGain;
+	}
+
+	void SoundSpatialStore::SetSpatialized(uint32_t index, bool spatialized)
+	{
+		GetPageFor(index).SpatialMask[GetLane(index)] = spatialized ? 1.0f : 0.0f;
+	}
+
+	void SoundSpatialStore::SetPositioning(uint32_t index, Positioning positioning)
+	{
+		GetPageFor(index).AbsoluteMask[GetLane(index)] = positioning == Positioning::Absolute ? 1.0f : 0.0f;
+	}
+
+	void SoundSpatialStore::SetPinnedListener(uint32_t index, uint32_t listenerIndex)
+	{
+		GetPageFor(index).PinnedListener[GetLane(index)] = listenerIndex < MaxListeners ? (float)listenerIndex : -1.0f;
+	}
+
+	void SoundSpatialStore::SetFlag(uint32_t index, SoundSpatialFlags flag, bool enabled)
+	{
+		uint8_t& flags = GetPageFor(index).Flags[GetLane(index)];
+		flags = enabled ? (flags | flag) : (flags & ~flag);
+	}
+
+	float SoundSpatialStore::GetGain(uint32_t index) const
+	{
+		return GetPageFor(index).Gain[GetLane(index)];
+	}
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Wave/Types.h"
+#include "Wave/Allocator.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace Wave {
+
+	enum SoundSpatialFlags : uint8_t
+	{
+		SpatialFlag_None    = 0,
+		SpatialFlag_Active  = 1 << 0, /* The slot holds a live sound. */
+		SpatialFlag_Playing = 1 << 1, /* The sound was started and hasn't been paused or stopped. */
+		SpatialFlag_Virtual = 1 << 2, /* Playing, but culled from the mix by the attenuation pass. */
+	};
+
+	// Hot per-sound state stored as structure-of-arrays and indexed by the sound's slot.
+	// Each page holds one contiguous array per field so per-frame passes over every
+	// sound stream through memory and can be vectorized a page at a time.
+	class SoundSpatialStore
+	{
+	public:
+		inline static constexpr uint32_t PageSize = 256;
+		inline static constexpr uint32_t MaxPages = 4096;
+
+		struct Page
+		{
+			alignas(32) float PositionX[PageSize];
+			alignas(32) float PositionY[PageSize];
+			alignas(32) float PositionZ[PageSize];
+
+			alignas(32) float VelocityX[PageSize];
+			alignas(32) float VelocityY[PageSize];
+			alignas(32) float VelocityZ[PageSize];
+
+			alignas(32) float DirectionX[PageSize];
+			alignas(32) float DirectionY[PageSize];
+			alignas(32) float DirectionZ[PageSize];
+
+			alignas(32) float Volume[PageSize];
+
+			// Distance attenuation parameters, mirroring what the sound's spatializer uses
+			alignas(32) float MinDistance[PageSize];
+			alignas(32) float MaxDistance[PageSize];
+			alignas(32) float Rolloff[PageSize];
+			alignas(32) float MinGain[PageSize];
+			alignas(32) float MaxGain[PageSize];
+			alignas(32) float Model[PageSize];
+
+			// Cone cutoffs are stored as cos(angle / 2), a disabled cone uses cutoffs below -1
+			alignas(32) float ConeInnerCos[PageSize];
+			alignas(32) float ConeOuterCos[PageSize];
+			alignas(32) float ConeOuterGain[PageSize];
+
+			// 1.0 when spatialized / absolutely positioned, 0.0 otherwise, so the kernel can blend without branching
+			alignas(32) float SpatialMask[PageSize];
+			alignas(32) float AbsoluteMask[PageSize];
+
+			// Listener index the sound is pinned to, -1 when it follows the closest listener
+			alignas(32) float PinnedListener[PageSize];
+
+			// Gain applied by the sound's occlusion filter
+			alignas(32) float OcclusionGain[PageSize];
+
+			// Output of the attenuation pass, excluding Volume
+			alignas(32) float Gain[PageSize];
+
+			uint32_t EngineIndex[PageSize];
+			uint8_t Flags[PageSize];
+		};
+
+	public:
+		SoundSpatialStore() = default;
+		~SoundSpatialStore();
+
+		SoundSpatialStore(const SoundSpatialStore&) = delete;
+		SoundSpatialStore& operator=(const SoundSpatialStore&) = delete;
+
+		// Pages are allocated through this from then on, must be set before the first Acquire
+		inline void SetAllocator(Allocator* allocator) { m_Allocator = allocator; }
+
+		// Allocates the pages for the first 'count' slots up front
+		bool Reserve(uint32_t count);
+
+		// Makes sure the page for a slot exists and resets the slot to its defaults
+		bool Acquire(uint32_t index, uint32_t engineIndex);
+		void Release(uint32_t index);
+
+		inline Page* GetPage(uint32_t pageIndex) { return m_Pages[pageIndex].load(std::memory_order_acquire); }
+		inline uint32_t GetPageCount() const { return m_PageCount.load(std::memory_order_acquire); }
+
+		inline Page& GetPageFor(uint32_t index) { return *GetPage(index / PageSize); }
+		inline const Page& GetPageFor(uint32_t index) const { return *m_Pages[index / PageSize].load(std::memory_order_acquire); }
+		inline static uint32_t GetLane(uint32_t index) { return index & (PageSize - 1); }
+
+		Vec3 GetPosition(uint32_t index) const;
+		void SetPosition(uint32_t index, float x, float y, float z);
+
+		Vec3 GetVelocity(uint32_t index) const;
+		void SetVelocity(uint32_t index, float x, float y, float z);
+
+		Vec3 GetDirection(uint32_t index) const;
+		void SetDirection(uint32_t index, float x, float y, float z);
+
+		float GetVolume(uint32_t index) const;
+		void SetVolume(uint32_t index, float volume);
+
+		float GetMinDistance(uint32_t index) const;
+		void SetMinDistance(uint32_t index, float minDistance);
+
+		float GetMaxDistance(uint32_t index) const;
+		void SetMaxDistance(uint32_t index, float maxDistance);
+
+		float GetRolloff(uint32_t index) const;
+		void SetRolloff(uint32_t index, float rolloff);
+
+		float GetMinGain(uint32_t index) const;
+		void SetMinGain(uint32_t index, float minGain);
+
+		float GetMaxGain(uint32_t index) const;
+		void SetMaxGain(uint32_t index, float maxGain);
+
+		void SetModel(uint32_t index, AttenuationModel model);
+		void SetCone(uint32_t index, const AudioCone& cone);
+		void SetSpatialized(uint32_t index, bool spatialized);
+		void SetPositioning(uint32_t index, Positioning positioning);
+		// Anything at or above MaxListeners unpins the sound
+		void SetPinnedListener(uint32_t index, uint32_t listenerIndex);
+
+		inline bool HasFlag(uint32_t index, SoundSpatialFlags flag) const { return (GetPageFor(index).Flags[GetLane(index)] & flag) != 0; }
+		void SetFlag(uint32_t index, SoundSpatialFlags flag, bool enabled);
+
+		float GetGain(uint32_t index) const;
+		inline uint32_t GetEngineIndex(uint32_t index) const { return GetPageFor(index).EngineIndex[GetLane(index)]; }
+
+	private:
+		bool EnsurePage(uint32_t pageIndex);
+
+	private:
+		std::atomic<Page*> m_Pages[MaxPages] = {};
+		std::atomic<uint32_t> m_PageCount = 0;
+		Allocator* m_Allocator = &Allocator::GetDefault();
+	};
+
+}
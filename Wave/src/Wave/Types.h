@@ -2,10 +2,14 @@
 
 #include "Wave/Utils.h"
 
+#include <cstddef>
 #include <cstdint>
 
 namespace Wave {
 
+	// Listeners an engine can have at most, matches miniaudio's MA_ENGINE_MAX_LISTENERS
+	inline constexpr uint32_t MaxListeners = 4;
+
 	enum class AttenuationModel : uint8_t
 	{
 		None = 0,
@@ -45,6 +49,19 @@ namespace Wave {
 		float OuterGain = 0.0f;
 	};
 
+	/* Replaces the system heap for a context, see ContextSettings::Allocation. Same layout as miniaudio's
+	   ma_allocation_callbacks, the callbacks are handed to miniaudio as they are. All three must be set, and
+	   Malloc must return memory aligned to at least alignof(std::max_align_t). */
+	struct AllocationCallbacks
+	{
+		void* pUserData = nullptr;
+		void* (*Malloc)(size_t size, void* userData) = nullptr;
+		void* (*Realloc)(void* ptr, size_t size, void* userData) = nullptr;
+		void (*Free)(void* ptr, void* userData) = nullptr;
+	};
+
+	/* Encoded audio held in memory. Wave never copies or frees it, the owner must keep it
+	   alive until every sound created from it has been destroyed. */
 	struct DataSource
 	{
 		uint8_t* Data;
@@ -3,7 +3,9 @@
 #include "Wave/Assert.h"
 #include "Wave/PlaybackDevice.h"
 #include "Wave/Context.h"
+#include "Wave/Error.h"
 #include "Wave/Engine.h"
 #include "Wave/Sound.h"
+#include "Wave/SoundBank.h"
 #include "Wave/Types.h"
 #include "Wave/ID.h"
@@ -0,0 +1,81 @@
+#include "WorkerPool.h"
+
+#include "Wave/Assert.h"
+
+namespace Wave {
+
+	WorkerPool::~WorkerPool()
+	{
+		Stop();
+	}
+
+	void WorkerPool::Start(uint32_t threadCount)
+	{
+		WAVE_ASSERT(m_Threads.empty(), "Worker pool already started!%s", "");
+
+		m_Stopping = false;
+
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			m_Threads.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+
+	void WorkerPool::Stop()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+		}
+
+		m_JobAvailable.notify_all();
+
+		for (std::thread& thread : m_Threads)
+		{
+			thread.join();
+		}
+
+		m_Threads.clear();
+	}
+
+	void WorkerPool::Submit(Job job)
+	{
+		// Without any threads the job runs on the caller, so work is never silently dropped
+		if (m_Threads.empty())
+		{
+			job();
+			return;
+		}
+
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_Jobs.push_back(std::move(job));
+		}
+
+		m_JobAvailable.notify_one();
+	}
+
+	void WorkerPool::WorkerLoop()
+	{
+		while (true)
+		{
+			Job job;
+
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_JobAvailable.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+
+				if (m_Jobs.empty())
+				{
+					return;
+				}
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Wave {
+
+	// Fixed set of background threads running jobs in submission order
+	class WorkerPool
+	{
+	public:
+		using Job = std::function<void()>;
+
+	public:
+		WorkerPool() = default;
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		void Start(uint32_t threadCount);
+
+		// Finishes every job already submitted, then joins the threads
+		void Stop();
+
+		void Submit(Job job);
+
+		inline uint32_t GetThreadCount() const { return (uint32_t)m_Threads.size(); }
+
+	private:
+		void WorkerLoop();
+
+	private:
+		std::vector<std::thread> m_Threads;
+		std::deque<Job> m_Jobs;
+		std::mutex m_Mutex;
+		std::condition_variable m_JobAvailable;
+		bool m_Stopping = false;
+	};
+
+}
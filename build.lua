@@ -13,4 +13,9 @@ group "Core"
     include "Wave/build-wave.lua"
 group ""
 
+group "Tools"
+    include "Tools/WavePack/build-wavepack.lua"
+    include "Tools/WaveBench/build-wavebench.lua"
+group ""
+
 include "App/build-app.lua"
\ No newline at end of file